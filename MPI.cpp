@@ -8,158 +8,146 @@
 #include <numeric>
 #include <mpi.h>
 
+#include "vrp.h"
+#include "arquivosolucao.h"
+
 using namespace std;
 using namespace std::chrono;
 
-// Funções de leitura dos arquivos e cálculo de custos (mantidas sem alteração)
-
-vector<int> LerDestinoDemanda(const string& nomeArquivo, int& numVertices) {
-    ifstream arquivo(nomeArquivo);
-    if (!arquivo.is_open()) {
-        cerr << "Erro ao abrir o arquivo " << nomeArquivo << endl;
-        exit(1);
-    }
-    
-    arquivo >> numVertices;
-
-    vector<int> grafo(numVertices, 0);
-    int destino, demanda;
-    for (int i = 1; i < numVertices; i++) {
-        arquivo >> destino >> demanda;
-        grafo[destino] = demanda;
-    }
-    arquivo.close();
-    return grafo;
-}
-
-vector<vector<int>> LerRotasPossiveis(const string& nomeArquivo, int& numVertices) {
-    ifstream arquivo(nomeArquivo);
-    if (!arquivo.is_open()) {
-        cerr << "Erro ao abrir o arquivo " << nomeArquivo << endl;
-        exit(1);
-    }
-
-    arquivo >> numVertices;
-     
-    for (int i = 0; i < numVertices-1; i++) {
-        int x, y;
-        arquivo >> x >> y;
-    }
+// Funções de leitura dos arquivos e cálculo de custos compartilhadas em vrp.h
 
-    int numRotas;
-    arquivo >> numRotas;
-
-    vector<vector<int>> grafo(numVertices, vector<int>(numVertices, 0));
-
-    int origem, destino, custo;
-    while (arquivo >> origem >> destino >> custo) {
-        grafo[origem][destino] = custo;
-    }
-    arquivo.close();
-    return grafo;
-}
-
-int calcularCusto(const vector<int>& rota, const vector<vector<int>>& rotas) {
-    int custo = 0;
-    for (size_t i = 0; i < rota.size() - 1; ++i) {
-        int origem = rota[i];
-        int destino = rota[i + 1];
-        if (rotas[origem][destino] == 0) {
-            return -1;
-        }
-        custo += rotas[origem][destino];
-    }
-    return custo;
-}
-
-int verificaCapacidade(const vector<int>& rota, const vector<int>& demandas, int capacidadeVeiculo){
-    int carga_total = 0;
-    for (int index : rota){
-        carga_total += demandas[index];
-    }
-    if (carga_total > capacidadeVeiculo){
-        return 0;
-    }
-    return 1;
-}
-
-bool rotaJaExiste(const vector<int>& sub, const vector<vector<int>>& combinacoesValidas) {
-    return find(combinacoesValidas.begin(), combinacoesValidas.end(), sub) != combinacoesValidas.end();
-}
-
-// Função para gerar todas as combinações possíveis de rotas válidas independente do custo
-void GerarTodasAsCombinacoesPossiveis(const vector<vector<int>>& rotas, int num_cidades, vector<vector<int>>& resultados, 
-                                      vector<int>& demandas, int capacidadeVeiculo) {
-    int n = rotas.size();
+// Função para gerar todas as combinações possíveis de rotas válidas independente do custo.
+// Cada thread avalia as suas permutações em lotes (avaliacaolote.h), um por posição da fatia, monta as rotas viáveis
+// numa única 'Rota' (RotaFixa<maxParadas> ou vector<int>) reaproveitada e as deduplica no seu PoolSequencias; os pools
+// das threads são unidos no fim, uma seção crítica por thread.
+template <typename Rota>
+void GerarTodasAsCombinacoesPossiveis(const MatrizPlana& matriz, int num_cidades, vector<vector<int>>& resultados,
+                                      int capacidadeVeiculo, LimitesExecucao& limites) {
+    int n = matriz.n;
     vector<int> indices(n);
     iota(indices.begin(), indices.end(), 0);
 
     vector<vector<int>> all_permutations;
+    FaseCronometrada faseGeracao("geracao_permutacoes");
     do {
         all_permutations.push_back(indices);
-    } while (next_permutation(indices.begin() + 1, indices.end()));
-
-    #pragma omp parallel for schedule(dynamic)
-    for (size_t k = 0; k < all_permutations.size(); ++k) {
-        const vector<int>& perm = all_permutations[k];
+    } while (!limites.parar() && next_permutation(indices.begin() + 1, indices.end()));
+    faseGeracao.encerrar();
+
+    FaseCronometrada faseAvaliacao("avaliacao_permutacoes");
+    // começa com as rotas das chamadas anteriores: a última fatia de uma permutação pode repetir uma rota mais curta
+    PoolSequencias aceitas;
+    for (const vector<int>& rota : resultados) aceitas.adicionar(rota);
+    uint32_t anteriores = aceitas.size();
+    #pragma omp parallel
+    {
+        Rota sub;
+        PoolSequencias aceitasThread;
+        vector<LoteRotas> lotes;
         for (int i = 0; i < n; i += num_cidades) {
-            int j = min(i + num_cidades, n);
-            vector<int> sub(perm.begin() + i, perm.begin() + j);
-            vector<int> rota_custo;
-            sub.insert(sub.begin(), 0);
-            sub.push_back(0);
-
-            if (calcularCusto(sub, rotas) != -1 && verificaCapacidade(sub, demandas, capacidadeVeiculo)) {
-                #pragma omp critical
-                {
-                    if (!rotaJaExiste(sub, resultados)) {
-                        resultados.push_back(sub);
-                    }
+            lotes.emplace_back(min(num_cidades, n - i) + 2, PERMUTACOES_POR_LOTE);
+        }
+
+        auto esvaziarLotes = [&]() {
+            for (LoteRotas& lote : lotes) avaliarLote(matriz, lote, capacidadeVeiculo);
+            for (int p = 0; p < lotes[0].quantidade; p++) {
+                for (const LoteRotas& lote : lotes) {
+                    if (!lote.viaveis[p]) continue;
+                    sub.clear();
+                    for (int k = 0; k < lote.comprimento; k++) sub.push_back(lote.no(p, k));
+                    if (!aceitasThread.adicionarSeNova(sub)) contar(DUPLICATAS_REJEITADAS);
+                }
+            }
+            for (LoteRotas& lote : lotes) lote.limpar();
+        };
+
+        #pragma omp for schedule(dynamic)
+        for (size_t k = 0; k < all_permutations.size(); ++k) {
+            if (k > 0 && limites.parar()) continue;
+            const vector<int>& perm = all_permutations[k];
+            contar(PERMUTACOES_VISITADAS);
+            for (size_t s = 0; s < lotes.size(); s++) {
+                LoteRotas& lote = lotes[s];
+                int i = s * num_cidades;
+                int* coluna = lote.nos.data() + lote.quantidade;
+                coluna[0] = 0;
+                for (int p = 1; p < lote.comprimento - 1; p++) {
+                    coluna[(size_t)p * lote.capacidade] = perm[i + p - 1];
+                }
+                coluna[(size_t)(lote.comprimento - 1) * lote.capacidade] = 0;
+                lote.quantidade++;
+            }
+            if (lotes[0].cheio()) esvaziarLotes();
+        }
+        esvaziarLotes();
+
+        long long espera = inicioEsperaSecaoCritica();
+        #pragma omp critical
+        {
+            entradaSecaoCritica();
+            for (uint32_t id = 0; id < aceitasThread.size(); id++) {
+                if (aceitas.adicionarSeNova(aceitasThread[id])) {
+                    contar(ROTAS_ACEITAS);
+                } else {
+                    contar(DUPLICATAS_REJEITADAS);
                 }
             }
+            fimSecaoCritica(espera);
         }
     }
+    for (uint32_t id = anteriores; id < aceitas.size(); id++) resultados.push_back(paraVetor(aceitas[id]));
+    faseAvaliacao.encerrar();
 
+    FaseCronometrada faseDeduplicacao("deduplicacao_rotas");
     sort(resultados.begin(), resultados.end());
     resultados.erase(unique(resultados.begin(), resultados.end()), resultados.end());
 }
 
-bool checkAllNodesWithoutOverlap(const vector<vector<int>>& routes, int totalNodes) {
-    set<int> visitedNodes;
-    for (const auto& route : routes) {
-        for (int node : route) {
-            if (node == 0) continue;
-            if (visitedNodes.find(node) != visitedNodes.end()) {
-                return false;
-            }
-            visitedNodes.insert(node);
+// Gera todas as rotas viáveis com até maxParadas-2 clientes, com RotaFixa<maxParadas> quando há instanciação para esse maxParadas
+void gerarRotasPossiveis(const vector<vector<int>>& locais, vector<int>& demandas, int C, int maxParadas, vector<vector<int>>& rotas_possiveis,
+                         LimitesExecucao& limites) {
+    MatrizPlana plana(locais, demandas);
+    despacharMaxParadas(maxParadas, [&](auto paradas) {
+        constexpr int M = decltype(paradas)::value;
+        using Rota = conditional_t<M == 0, vector<int>, RotaFixa<M == 0 ? 1 : M>>;
+        for (int num_cidades = 1; num_cidades < maxParadas - 1; ++num_cidades) {
+            GerarTodasAsCombinacoesPossiveis<Rota>(plana, num_cidades, rotas_possiveis, C, limites);
         }
-    }
-    return visitedNodes.size() == totalNodes - 1;
+    });
 }
 
 void gerarCombinacoesRecursivo(const vector<vector<int>>& rotas, vector<int>& combinacaoAtual, vector<vector<int>>& todasCombinacoes, 
-                               int tamanho_itinerario, int numVertices, int inicio) {
+                               int tamanho_itinerario, int numVertices, int inicio, LimitesExecucao& limites) {
+    if (limites.parar()) return;
+    contar(COMBINACOES_VISITADAS);
+
     if (combinacaoAtual.size() == tamanho_itinerario) {
         vector<vector<int>> vetor_de_verdade;
         for (int local : combinacaoAtual) {
             vetor_de_verdade.push_back(rotas[local]);
         }
         if (checkAllNodesWithoutOverlap(vetor_de_verdade, numVertices)) {
+            long long espera = inicioEsperaSecaoCritica();
             #pragma omp critical
-            todasCombinacoes.push_back(combinacaoAtual);
+            {
+                entradaSecaoCritica();
+                todasCombinacoes.push_back(combinacaoAtual);
+                fimSecaoCritica(espera);
+            }
+        } else {
+            contar(COMBINACOES_PODADAS);
         }
         return;
     }
 
     for (size_t i = inicio; i < rotas.size(); ++i) {
         combinacaoAtual.push_back(i);
-        gerarCombinacoesRecursivo(rotas, combinacaoAtual, todasCombinacoes, tamanho_itinerario, numVertices, i + 1);
+        gerarCombinacoesRecursivo(rotas, combinacaoAtual, todasCombinacoes, tamanho_itinerario, numVertices, i + 1, limites);
         combinacaoAtual.pop_back();
     }
 }
 
-vector<vector<int>> gerarTodasAsCombinacoesItinerario(const vector<vector<int>>& rotas, int numVertices) {
+vector<vector<int>> gerarTodasAsCombinacoesItinerario(const vector<vector<int>>& rotas, int numVertices, LimitesExecucao& limites) {
     vector<vector<int>> todasCombinacoes;
     
     #pragma omp parallel
@@ -169,31 +157,26 @@ vector<vector<int>> gerarTodasAsCombinacoesItinerario(const vector<vector<int>>&
 
         #pragma omp for schedule(dynamic)
         for (int k = 1; k <= rotas.size(); ++k) {
-            gerarCombinacoesRecursivo(rotas, combinacaoAtual, todasCombinacoesLocal, k, numVertices, 0);
+            RegiaoRastreada regiao("itinerarios_k", k);   // uma região por tamanho de itinerário, para ver o desequilíbrio
+            gerarCombinacoesRecursivo(rotas, combinacaoAtual, todasCombinacoesLocal, k, numVertices, 0, limites);
         }
 
+        long long espera = inicioEsperaSecaoCritica();
         #pragma omp critical
         {
+            entradaSecaoCritica();
             todasCombinacoes.insert(todasCombinacoes.end(), todasCombinacoesLocal.begin(), todasCombinacoesLocal.end());
+            fimSecaoCritica(espera);
         }
     }
 
+    FaseCronometrada faseDeduplicacao("deduplicacao_itinerarios");
     sort(todasCombinacoes.begin(), todasCombinacoes.end());
     todasCombinacoes.erase(unique(todasCombinacoes.begin(), todasCombinacoes.end()), todasCombinacoes.end());
 
     return todasCombinacoes;
 }
 
-int calculaCustoTotal(const vector<int>& combinacao, const vector<vector<int>>& rotas_possiveis, const vector<vector<int>>& rotas) {
-    int custoTotal = 0;
-    for (const auto& indiceRota : combinacao) {
-        int custoRota = calcularCusto(rotas_possiveis[indiceRota], rotas);
-        if (custoRota == -1) return -1;
-        custoTotal += custoRota;
-    }
-    return custoTotal;
-}
-
 int calcula_menor_custo_itinerarios(const vector<vector<int>>& todasCombinacoes, const vector<vector<int>>& rotas_possiveis, const vector<vector<int>>& rotas) {
     int menorCusto = numeric_limits<int>::max();
     vector<int> menorCustoIndices;
@@ -224,42 +207,260 @@ int calcula_menor_custo_itinerarios(const vector<vector<int>>& todasCombinacoes,
     return menorCusto;
 }    
 
-int ResolverVRPComDemanda(vector<vector<int>> locais, vector<int> demandas, int C, int& numVertices, int rank, int size) {
+// Custo dos itinerários i = rank, rank + size, ... (divisão estática entre ranks), em paralelo nas threads do rank.
+// 'itinerarios', 'rotas' e 'locais' são os vetores do rank ou as visões do segmento compartilhado.
+template <typename Itinerarios, typename Pool, typename Matriz>
+void custoItinerariosDoRank(const Itinerarios& todasCombinacoes, const Pool& rotas_possiveis, const Matriz& locais, int rank, int size,
+                            LimitesExecucao& limites, Incumbente& incumbente) {
+    FaseCronometrada faseCusto("custo_itinerarios");
+    #pragma omp parallel
+    {
+        // trecho de cada thread na divisão estática (i += size entre ranks), sem a espera na barreira final
+        RegiaoRastreada regiao("custo_itinerarios_thread");
+        #pragma omp for nowait
+        for (size_t i = rank; i < todasCombinacoes.size(); i += size) {
+            if (incumbente.existe() && limites.parar()) continue;
+            contar(ITINERARIOS_AVALIADOS);
+            const auto& combinacao = todasCombinacoes[i];
+            int custoTotal = calculaCustoTotal(combinacao, rotas_possiveis, locais);
+            if (custoTotal != -1 && custoTotal < incumbente.custo) {
+                vector<vector<int>> rotasCombinacao;
+                for (int index : combinacao) {
+                    rotasCombinacao.push_back(vector<int>(rotas_possiveis[index].begin(), rotas_possiveis[index].end()));
+                }
+                incumbente.oferecer(custoTotal, rotasCombinacao, limites);
+            }
+        }
+    }
+}
+
+// cada rank para no proprio limite; o MPI_Allreduce (MINLOC) junta as melhores solucoes parciais e aponta o rank
+// que tem a melhor, que envia as rotas dela ao rank 0 (tamanho, nós e custo de cada rota num único vetor)
+template <typename Matriz>
+int reduzirMenorCusto(Incumbente& incumbente, const Matriz& locais, int rank, LimitesExecucao& limites, vector<vector<int>>* rotasSaida) {
+    struct { int custo; int rank; } menorLocal = {incumbente.custo, rank}, menorGlobal;
+    {
+        RegiaoRastreada regiao("MPI_Allreduce");
+        MPI_Allreduce(&menorLocal, &menorGlobal, 1, MPI_2INT, MPI_MINLOC, MPI_COMM_WORLD);
+    }
+
+    vector<int> rotasPlanas;
+    if (rank == menorGlobal.rank) {
+        for (const auto& rota : incumbente.rotas) {
+            rotasPlanas.push_back(rota.size());
+            rotasPlanas.insert(rotasPlanas.end(), rota.begin(), rota.end());
+            rotasPlanas.push_back(calcularCusto(rota, locais));
+        }
+    }
+    if (menorGlobal.rank != 0 && (rank == 0 || rank == menorGlobal.rank)) {
+        RegiaoRastreada regiao("MPI_rotas_da_melhor_solucao");
+        if (rank == menorGlobal.rank) {
+            MPI_Send(rotasPlanas.data(), rotasPlanas.size(), MPI_INT, 0, 0, MPI_COMM_WORLD);
+        } else {
+            MPI_Status status;
+            int tamanho;
+            MPI_Probe(menorGlobal.rank, 0, MPI_COMM_WORLD, &status);
+            MPI_Get_count(&status, MPI_INT, &tamanho);
+            rotasPlanas.resize(tamanho);
+            MPI_Recv(rotasPlanas.data(), tamanho, MPI_INT, menorGlobal.rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+    }
+
+    if (rank == 0) {
+        if (limites.esgotado) {
+            cout << "Limite de execução atingido, exibindo a melhor solução encontrada" << endl;
+        }
+        cout << "Menor custo: " << (menorGlobal.custo == INT_MAX ? "nenhuma solução encontrada" : to_string(menorGlobal.custo)) << "\n";
+        cout << "Rotas finais:\n";
+        vector<vector<int>> rotas;
+        for (size_t i = 0; i < rotasPlanas.size();) {
+            int tamanho = rotasPlanas[i++];
+            rotas.emplace_back(rotasPlanas.begin() + i, rotasPlanas.begin() + i + tamanho);
+            i += tamanho;
+            for (int local : rotas.back()) {
+                cout << local << " ";
+            }
+            cout << "(Custo: " << rotasPlanas[i++] << ")\n";
+        }
+        cout << flush;
+        if (rotasSaida) *rotasSaida = move(rotas);
+    }
+
+    return menorGlobal.custo;
+}
+
+int ResolverVRPComDemanda(vector<vector<int>> locais, vector<int> demandas, int C, int& numVertices, int rank, int size,
+                          LimitesExecucao& limites, vector<vector<int>>* rotasSaida = nullptr) {
     int maxParadas = 5;
     vector<vector<int>> rotas_possiveis;
+    Incumbente incumbente;
+    incumbente.silencioso = (rank != 0);  // cada rank avalia só a sua parte; so o rank 0 transmite as melhorias que encontra
+    oferecerRotasIndividuais(locais, demandas, C, numVertices, limites, incumbente);
 
-    for (int num_cidades = 1; num_cidades < maxParadas - 1; ++num_cidades) {
-        GerarTodasAsCombinacoesPossiveis(locais, num_cidades, rotas_possiveis, demandas, C);
-    }
+    FaseCronometrada faseRotas("geracao_rotas");
+    gerarRotasPossiveis(locais, demandas, C, maxParadas, rotas_possiveis, limites);
+    faseRotas.encerrar();
 
-    vector<vector<int>> todasCombinacoes = gerarTodasAsCombinacoesItinerario(rotas_possiveis, numVertices);
+    FaseCronometrada faseEnumeracao("enumeracao_itinerarios");
+    vector<vector<int>> todasCombinacoes = gerarTodasAsCombinacoesItinerario(rotas_possiveis, numVertices, limites);
+    faseEnumeracao.encerrar();
 
-    int menorCustoLocal = numeric_limits<int>::max();
-    vector<int> menorCustoIndices;
+    custoItinerariosDoRank(todasCombinacoes, rotas_possiveis, locais, rank, size, limites, incumbente);
+    return reduzirMenorCusto(incumbente, locais, rank, limites, rotasSaida);
+}
 
-    #pragma omp parallel for
-    for (size_t i = rank; i < todasCombinacoes.size(); i += size) {
-        const auto& combinacao = todasCombinacoes[i];
-        int custoTotal = calculaCustoTotal(combinacao, rotas_possiveis, locais);
-        if (custoTotal != -1 && custoTotal < menorCustoLocal) {
-            #pragma omp critical
-            {
-                if (custoTotal < menorCustoLocal) {
-                    menorCustoLocal = custoTotal;
-                    menorCustoIndices = combinacao;
-                }
+// Modo --memoria-compartilhada: os ranks de um mesmo nó (MPI_COMM_TYPE_SHARED) usam uma única cópia da matriz,
+// do conjunto de rotas e dos itinerários, num segmento MPI_Win_allocate_shared. Só o primeiro rank de cada nó lê
+// a instância, gera as rotas e enumera os itinerários; ele copia tudo para o segmento, libera as próprias cópias,
+// e todos os ranks do nó calculam o custo da sua parte lendo o segmento diretamente, sem cópia.
+
+// Matriz n x n no segmento; mesma interface de leitura de vector<vector<int>>
+struct MatrizCompartilhada {
+    const int* celulas;
+    size_t n;
+
+    size_t size() const { return n; }
+    const int* operator[](size_t i) const { return celulas + i * n; }
+};
+
+// Rotas ou itinerários no segmento, no formato CSR de poolrotas.h (com inícios de 64 bits)
+struct SequenciasCompartilhadas {
+    const long long* inicios;
+    const int* nos;
+    size_t quantidade;
+
+    size_t size() const { return quantidade; }
+    VisaoSequencia operator[](size_t id) const { return {nos + inicios[id], nos + inicios[id + 1]}; }
+};
+
+struct InstanciaCompartilhada {
+    MPI_Win janela = MPI_WIN_NULL;
+    MPI_Aint bytes = 0;
+    MatrizCompartilhada locais;
+    SequenciasCompartilhadas rotas;
+    SequenciasCompartilhadas itinerarios;
+};
+
+// Cria o segmento do nó, preenchido pelo rank 0 de 'comNo' a partir dos seus vetores (os demais passam vetores vazios)
+InstanciaCompartilhada compartilharNoNo(MPI_Comm comNo, int rankNo, const vector<vector<int>>& locais,
+                                        const vector<vector<int>>& rotas, const vector<vector<int>>& itinerarios) {
+    // n, rotas, nós das rotas, itinerários, ids dos itinerários
+    long long tamanhos[5] = {(long long)locais.size(), (long long)rotas.size(), 0, (long long)itinerarios.size(), 0};
+    for (const auto& rota : rotas) tamanhos[2] += rota.size();
+    for (const auto& itinerario : itinerarios) tamanhos[4] += itinerario.size();
+    MPI_Bcast(tamanhos, 5, MPI_LONG_LONG, 0, comNo);
+    long long n = tamanhos[0], numRotas = tamanhos[1], nosRotas = tamanhos[2], numItinerarios = tamanhos[3], idsItinerarios = tamanhos[4];
+
+    auto alinhar = [](MPI_Aint deslocamento) { return (deslocamento + 7) & ~(MPI_Aint)7; };
+    MPI_Aint inicioRotas = alinhar(n * n * sizeof(int));
+    MPI_Aint nosDasRotas = inicioRotas + (numRotas + 1) * sizeof(long long);
+    MPI_Aint inicioItinerarios = alinhar(nosDasRotas + nosRotas * sizeof(int));
+    MPI_Aint idsDosItinerarios = inicioItinerarios + (numItinerarios + 1) * sizeof(long long);
+    MPI_Aint total = idsDosItinerarios + idsItinerarios * sizeof(int);
+
+    InstanciaCompartilhada instancia;
+    char* base = nullptr;
+    MPI_Win_allocate_shared(rankNo == 0 ? total : 0, 1, MPI_INFO_NULL, comNo, &base, &instancia.janela);
+    if (rankNo != 0) {
+        MPI_Aint tamanho;
+        int unidade;
+        MPI_Win_shared_query(instancia.janela, 0, &tamanho, &unidade, &base);
+    }
+    instancia.bytes = total;
+
+    MPI_Win_fence(0, instancia.janela);
+    if (rankNo == 0) {
+        int* celulas = (int*)base;
+        for (long long i = 0; i < n; i++) copy(locais[i].begin(), locais[i].end(), celulas + i * n);
+        auto preencher = [&](const vector<vector<int>>& sequencias, MPI_Aint inicios, MPI_Aint nos) {
+            long long* destinoInicios = (long long*)(base + inicios);
+            int* destinoNos = (int*)(base + nos);
+            long long posicao = 0;
+            for (size_t id = 0; id < sequencias.size(); id++) {
+                destinoInicios[id] = posicao;
+                copy(sequencias[id].begin(), sequencias[id].end(), destinoNos + posicao);
+                posicao += sequencias[id].size();
             }
-        }
+            destinoInicios[sequencias.size()] = posicao;
+        };
+        preencher(rotas, inicioRotas, nosDasRotas);
+        preencher(itinerarios, inicioItinerarios, idsDosItinerarios);
     }
+    MPI_Win_fence(0, instancia.janela);
 
-    int menorCustoGlobal;
-    MPI_Reduce(&menorCustoLocal, &menorCustoGlobal, 1, MPI_INT, MPI_MIN, 0, MPI_COMM_WORLD);
+    instancia.locais = {(const int*)base, (size_t)n};
+    instancia.rotas = {(const long long*)(base + inicioRotas), (const int*)(base + nosDasRotas), (size_t)numRotas};
+    instancia.itinerarios = {(const long long*)(base + inicioItinerarios), (const int*)(base + idsDosItinerarios), (size_t)numItinerarios};
+    return instancia;
+}
 
+// Como ResolverVRPComDemanda, com geração e enumeração só no primeiro rank de cada nó e o resultado no segmento compartilhado
+int ResolverVRPMemoriaCompartilhada(vector<vector<int>> locais, vector<int> demandas, int C, int& numVertices, int rank, int size,
+                                    MPI_Comm comNo, LimitesExecucao& limites, vector<vector<int>>* rotasSaida = nullptr) {
+    int maxParadas = 5;
+    int rankNo, ranksNo;
+    MPI_Comm_rank(comNo, &rankNo);
+    MPI_Comm_size(comNo, &ranksNo);
+    vector<vector<int>> rotas_possiveis;
+    vector<vector<int>> todasCombinacoes;
+    Incumbente incumbente;
+    incumbente.silencioso = (rank != 0);
+
+    if (rankNo == 0) {
+        oferecerRotasIndividuais(locais, demandas, C, numVertices, limites, incumbente);
+
+        FaseCronometrada faseRotas("geracao_rotas");
+        gerarRotasPossiveis(locais, demandas, C, maxParadas, rotas_possiveis, limites);
+        faseRotas.encerrar();
+
+        FaseCronometrada faseEnumeracao("enumeracao_itinerarios");
+        todasCombinacoes = gerarTodasAsCombinacoesItinerario(rotas_possiveis, numVertices, limites);
+        faseEnumeracao.encerrar();
+    }
+
+    InstanciaCompartilhada instancia;
+    {
+        FaseCronometrada fase("memoria_compartilhada");
+        RegiaoRastreada regiao("MPI_Win_allocate_shared");
+        instancia = compartilharNoNo(comNo, rankNo, locais, rotas_possiveis, todasCombinacoes);
+    }
+    // as cópias privadas do primeiro rank não são mais usadas
+    vector<vector<int>>().swap(locais);
+    vector<vector<int>>().swap(rotas_possiveis);
+    vector<vector<int>>().swap(todasCombinacoes);
     if (rank == 0) {
-        cout << "Menor custo: " << menorCustoGlobal << endl;
+        cerr << "Memória compartilhada: " << ranksNo << " rank(s) no nó, segmento de " << instancia.bytes << " bytes" << endl;
     }
+    registrarSecaoInstrumentacao("segmento_compartilhado", "{\"ranks_no_no\": " + to_string(ranksNo) + ", \"rank_no_no\": " +
+                                 to_string(rankNo) + ", \"bytes_segmento\": " + to_string((long long)instancia.bytes) + "}");
 
-    return menorCustoGlobal;
+    custoItinerariosDoRank(instancia.itinerarios, instancia.rotas, instancia.locais, rank, size, limites, incumbente);
+    int menorCusto = reduzirMenorCusto(incumbente, instancia.locais, rank, limites, rotasSaida);
+    MPI_Win_free(&instancia.janela);
+    return menorCusto;
+}
+
+// Junta a linha do tempo de todos os ranks num único arquivo, gravado pelo rank 0 (--rastreamento)
+void juntarRastreamento(int rank, int size) {
+    if (!rastreamentoAtivo()) return;
+    string local = eventosRastreamentoJson();
+    int tamanhoLocal = local.size();
+    vector<int> tamanhos(size), deslocamentos(size);
+    MPI_Gather(&tamanhoLocal, 1, MPI_INT, tamanhos.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+    string todos;
+    if (rank == 0) {
+        for (int r = 0, total = 0; r < size; r++) {
+            deslocamentos[r] = total;
+            total += tamanhos[r];
+        }
+        todos.resize(deslocamentos[size - 1] + tamanhos[size - 1]);
+    }
+    MPI_Gatherv(local.data(), tamanhoLocal, MPI_CHAR, &todos[0], tamanhos.data(), deslocamentos.data(), MPI_CHAR, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        vector<string> partes;
+        for (int r = 0; r < size; r++) partes.push_back(todos.substr(deslocamentos[r], tamanhos[r]));
+        gravarRastreamento(partes);
+    }
 }
 
 int main(int argc, char* argv[]) {
@@ -271,20 +472,51 @@ int main(int argc, char* argv[]) {
 
     int C = 15;
     int numVertices;
-    vector<int> demandas = LerDestinoDemanda("grafo.txt", numVertices);
-    vector<vector<int>> locais = LerRotasPossiveis("grafo.txt", numVertices);
+    LimitesExecucao limites;
+    LerLimites(argc, argv, limites);
+    LerInstrumentacao(argc, argv, "MPI", size > 1 ? ".rank" + to_string(rank) : "");
+    // um processo por rank na linha do tempo; o arquivo único é gravado por juntarRastreamento
+    rastreamento().processo = rank;
+    rastreamento().nomeProcesso = "MPI rank " + to_string(rank);
+    rastreamento().gravarNoFim = false;
+
+    bool memoriaCompartilhada = false;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--memoria-compartilhada") memoriaCompartilhada = true;
+    }
+    // ranks do mesmo nó (memória compartilhada); no modo --memoria-compartilhada só o primeiro de cada nó lê a instância
+    MPI_Comm comNo = MPI_COMM_NULL;
+    int rankNo = 0;
+    if (memoriaCompartilhada) {
+        MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &comNo);
+        MPI_Comm_rank(comNo, &rankNo);
+    }
+
+    vector<int> demandas;
+    vector<vector<int>> locais;
+    if (rankNo == 0) {
+        FaseCronometrada fase("leitura");
+        demandas = LerDestinoDemanda("grafo.txt", numVertices);
+        locais = LerRotasPossiveis("grafo.txt", numVertices);
+    }
 
     auto start = high_resolution_clock::now();
     
-    int resultado = ResolverVRPComDemanda(locais, demandas, C, numVertices, rank, size);
+    vector<vector<int>> rotas;
+    int resultado = memoriaCompartilhada
+        ? ResolverVRPMemoriaCompartilhada(move(locais), move(demandas), C, numVertices, rank, size, comNo, limites, &rotas)
+        : ResolverVRPComDemanda(locais, demandas, C, numVertices, rank, size, limites, &rotas);
     
     auto end = high_resolution_clock::now();
     
     if (rank == 0) {
         auto duration = duration_cast<milliseconds>(end - start).count();
         cout << "Tempo de execução: " << duration << " ms" << endl;
+        gravarSolucaoSePedida(argc, argv, {"MPI", numVertices, C, 5, resultado, limites.esgotado}, rotas);
     }
 
+    juntarRastreamento(rank, size);
+    if (comNo != MPI_COMM_NULL) MPI_Comm_free(&comNo);
     MPI_Finalize();
     return 0;
 }
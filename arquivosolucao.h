@@ -0,0 +1,345 @@
+#ifndef ARQUIVOSOLUCAO_H
+#define ARQUIVOSOLUCAO_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Arquivo de solução (--solucao <arquivo>), com o mesmo esquema para todos os resolvedores, em texto ou em
+// binário (arquivo terminado em .bin). Lido pelo validador (validador.cpp).
+//
+// Texto:
+//   vrp-solucao 1
+//   programa <nome>
+//   vertices <n>
+//   capacidade <C>
+//   max_paradas <m>          conta a saída e a volta ao depósito, como nos programas; 0 = sem limite
+//   custo <custo total>
+//   limite_atingido <0|1>
+//   rotas <número de rotas>
+//   0 3 7 0                  uma rota por linha, com o depósito no início e no fim
+// Binário:
+//   "VRSB" | int32 versão | int32 vértices | int32 capacidade | int32 maxParadas | int32 limite atingido | int64 custo |
+//   int64 rotas | int32 tamanho do nome | nome | por rota: int32 clientes, int32 clientes[] (o depósito fica implícito;
+//   o escritor recusa rotas que não começam e terminam no depósito 0, que não teriam como ser lidas de volta)
+//
+// O escritor acumula a saída num buffer e o grava com fwrite quando ele enche, sem flush por linha.
+
+struct CabecalhoSolucao {
+    std::string programa;
+    int vertices = 0;
+    int capacidade = 0;
+    int maxParadas = 0;
+    long long custo = 0;
+    bool limiteAtingido = false;
+    long long rotas = 0;
+};
+
+inline bool arquivoSolucaoBinario(const std::string& arquivo) {
+    return arquivo.size() >= 4 && arquivo.compare(arquivo.size() - 4, 4, ".bin") == 0;
+}
+
+class EscritorSolucao {
+public:
+    static const size_t TAMANHO_BUFFER = 1 << 20;
+
+    explicit EscritorSolucao(const std::string& arquivo)
+        : binario(arquivoSolucaoBinario(arquivo)), saida(std::fopen(arquivo.c_str(), "wb")) {
+        buffer.reserve(TAMANHO_BUFFER + 64);
+    }
+    ~EscritorSolucao() { fechar(); }
+
+    bool aberto() const { return saida != nullptr; }
+
+    void cabecalho(const CabecalhoSolucao& c) {
+        if (binario) {
+            buffer.append("VRSB", 4);
+            int32_t campos[5] = {1, c.vertices, c.capacidade, c.maxParadas, c.limiteAtingido};
+            buffer.append(reinterpret_cast<const char*>(campos), sizeof(campos));
+            int64_t totais[2] = {c.custo, c.rotas};
+            buffer.append(reinterpret_cast<const char*>(totais), sizeof(totais));
+            int32_t tamanhoNome = c.programa.size();
+            buffer.append(reinterpret_cast<const char*>(&tamanhoNome), sizeof(tamanhoNome));
+            buffer += c.programa;
+        } else {
+            buffer += "vrp-solucao 1\nprograma " + c.programa + "\nvertices " + std::to_string(c.vertices) +
+                      "\ncapacidade " + std::to_string(c.capacidade) + "\nmax_paradas " + std::to_string(c.maxParadas) +
+                      "\ncusto " + std::to_string(c.custo) + "\nlimite_atingido " + (c.limiteAtingido ? "1" : "0") +
+                      "\nrotas " + std::to_string(c.rotas) + "\n";
+        }
+        descarregarSeCheio();
+    }
+
+    template <typename Rota>
+    void rota(const Rota& rota) {
+        if (binario) {
+            if (rota.size() < 2 || rota[0] != 0 || rota[rota.size() - 1] != 0) {
+                if (erro.empty()) erro = "rota sem o depósito 0 no início e no fim (o formato binário o deixa implícito)";
+                return;
+            }
+            int32_t clientes = rota.size() >= 2 ? rota.size() - 2 : 0;
+            buffer.append(reinterpret_cast<const char*>(&clientes), sizeof(clientes));
+            for (size_t i = 1; i + 1 < rota.size(); i++) {
+                int32_t cliente = rota[i];
+                buffer.append(reinterpret_cast<const char*>(&cliente), sizeof(cliente));
+                descarregarSeCheio();
+            }
+        } else {
+            char numero[16];
+            for (size_t i = 0; i < rota.size(); i++) {
+                char* fim = std::to_chars(numero, numero + sizeof(numero), (int)rota[i]).ptr;
+                if (i) buffer += ' ';
+                buffer.append(numero, fim - numero);
+                descarregarSeCheio();
+            }
+            buffer += '\n';
+        }
+        descarregarSeCheio();
+    }
+
+    // Grava o que falta; devolve a mensagem de erro (vazia se tudo foi gravado)
+    std::string fechar() {
+        if (!saida) return erro;
+        descarregar();
+        if (std::fclose(saida) != 0 && erro.empty()) erro = "falha ao fechar o arquivo";
+        saida = nullptr;
+        return erro;
+    }
+
+private:
+    bool binario;
+    std::FILE* saida;
+    std::string buffer;
+    std::string erro;
+
+    void descarregar() {
+        if (saida && !buffer.empty() && std::fwrite(buffer.data(), 1, buffer.size(), saida) != buffer.size() && erro.empty()) {
+            erro = "falha na escrita";
+        }
+        buffer.clear();
+    }
+    void descarregarSeCheio() {
+        if (buffer.size() >= TAMANHO_BUFFER) descarregar();
+    }
+};
+
+// Grava a solução inteira; 'cabecalho.rotas' é preenchido com o número de rotas.
+// Devolve a mensagem de erro (vazia se a gravação deu certo).
+template <typename Rotas>
+inline std::string gravarSolucao(const std::string& arquivo, CabecalhoSolucao cabecalho, const Rotas& rotas) {
+    EscritorSolucao escritor(arquivo);
+    if (!escritor.aberto()) return "não foi possível criar o arquivo";
+    cabecalho.rotas = rotas.size();
+    escritor.cabecalho(cabecalho);
+    for (const auto& rota : rotas) escritor.rota(rota);
+    return escritor.fechar();
+}
+
+// Valor de --solucao <arquivo> (vazio se a opção não foi passada)
+inline std::string LerArquivoSolucao(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--solucao") return argv[i + 1];
+    }
+    return "";
+}
+
+// Grava a solução em --solucao <arquivo>, se a opção foi passada (avisa na saída de erro se a gravação falhar).
+// Sem rotas numa instância com clientes não há solução (o limite foi atingido antes da primeira): nada é gravado,
+// para que um arquivo antigo não seja trocado por um que o validador rejeitaria.
+template <typename Rotas>
+inline void gravarSolucaoSePedida(int argc, char* argv[], const CabecalhoSolucao& cabecalho, const Rotas& rotas) {
+    std::string arquivo = LerArquivoSolucao(argc, argv);
+    if (arquivo.empty()) return;
+    if (rotas.empty() && cabecalho.vertices > 1) {
+        std::fprintf(stderr, "Nenhuma solução encontrada; %s não foi gravado\n", arquivo.c_str());
+        return;
+    }
+    std::string erro = gravarSolucao(arquivo, cabecalho, rotas);
+    if (!erro.empty()) {
+        std::fprintf(stderr, "Erro ao gravar o arquivo %s: %s\n", arquivo.c_str(), erro.c_str());
+    }
+}
+
+// Solução lida, com as rotas no formato CSR (depósito no início e no fim de cada rota, também no binário)
+struct SolucaoLida {
+    CabecalhoSolucao cabecalho;
+    std::vector<long long> inicios;
+    std::vector<int> nos;
+
+    size_t numRotas() const { return inicios.empty() ? 0 : inicios.size() - 1; }
+};
+
+// Rotas de um trecho do texto (linhas inteiras), lidas por uma thread
+struct TrechoSolucao {
+    const char* inicio;
+    const char* fim;
+    std::vector<long long> tamanhos;
+    std::vector<int> nos;
+    bool invalido = false;
+};
+
+inline void lerTrechoSolucao(TrechoSolucao& trecho) {
+    const char* p = trecho.inicio;
+    while (p < trecho.fim) {
+        long long tamanho = 0;
+        while (p < trecho.fim && *p != '\n') {
+            if (*p == ' ' || *p == '\t' || *p == '\r') { p++; continue; }
+            int no;
+            auto [proximo, erro] = std::from_chars(p, trecho.fim, no);
+            if (erro != std::errc()) {
+                trecho.invalido = true;
+                return;
+            }
+            trecho.nos.push_back(no);
+            tamanho++;
+            p = proximo;
+        }
+        if (tamanho > 0) trecho.tamanhos.push_back(tamanho);
+        p++;
+    }
+}
+
+// Lê o arquivo de solução; devolve a mensagem de erro (vazia se a leitura deu certo).
+// No texto as rotas são lidas em paralelo, em trechos de linhas inteiras.
+inline std::string LerSolucao(const std::string& arquivo, SolucaoLida& solucao) {
+    std::FILE* entrada = std::fopen(arquivo.c_str(), "rb");
+    if (!entrada) return "Erro ao abrir o arquivo " + arquivo;
+    std::string dados;
+    char bloco[1 << 16];
+    size_t lidos;
+    while ((lidos = std::fread(bloco, 1, sizeof(bloco), entrada)) > 0) dados.append(bloco, lidos);
+    std::fclose(entrada);
+    CabecalhoSolucao& c = solucao.cabecalho;
+
+    if (dados.size() >= 4 && std::memcmp(dados.data(), "VRSB", 4) == 0) {
+        size_t pos = 4;
+        auto ler = [&](void* destino, size_t bytes) {
+            if (pos + bytes > dados.size()) return false;
+            std::memcpy(destino, dados.data() + pos, bytes);
+            pos += bytes;
+            return true;
+        };
+        int32_t campos[5], tamanhoNome;
+        int64_t totais[2];
+        if (!ler(campos, sizeof(campos)) || campos[0] != 1 || !ler(totais, sizeof(totais)) || !ler(&tamanhoNome, sizeof(tamanhoNome)) ||
+            tamanhoNome < 0 || pos + tamanhoNome > dados.size() || totais[1] < 0) {
+            return "Formato binário inválido em " + arquivo;
+        }
+        c.vertices = campos[1];
+        c.capacidade = campos[2];
+        c.maxParadas = campos[3];
+        c.limiteAtingido = campos[4];
+        c.custo = totais[0];
+        c.rotas = totais[1];
+        c.programa = dados.substr(pos, tamanhoNome);
+        pos += tamanhoNome;
+        // cada rota ocupa ao menos os 4 bytes do número de clientes: um cabeçalho que declara mais rotas do que cabe
+        // no arquivo é recusado antes de alocar os vetores
+        if ((unsigned long long)c.rotas > (dados.size() - pos) / sizeof(int32_t)) {
+            return "O cabeçalho de " + arquivo + " declara " + std::to_string(c.rotas) + " rotas, mais do que cabe no arquivo";
+        }
+
+        // posição de cada rota no arquivo (passada sequencial, só pelos tamanhos) e cópia em paralelo
+        std::vector<size_t> posicoes(c.rotas);
+        solucao.inicios.assign(c.rotas + 1, 0);
+        for (long long r = 0; r < c.rotas; r++) {
+            int32_t clientes;
+            if (!ler(&clientes, sizeof(clientes)) || clientes < 0 || pos + (size_t)clientes * sizeof(int32_t) > dados.size()) {
+                return "Rota " + std::to_string(r) + " truncada em " + arquivo;
+            }
+            posicoes[r] = pos;
+            pos += (size_t)clientes * sizeof(int32_t);
+            solucao.inicios[r + 1] = solucao.inicios[r] + clientes + 2;
+        }
+        solucao.nos.resize(solucao.inicios[c.rotas]);
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static, 4096)
+#endif
+        for (long long r = 0; r < c.rotas; r++) {
+            long long inicio = solucao.inicios[r], fim = solucao.inicios[r + 1];
+            solucao.nos[inicio] = 0;
+            std::memcpy(&solucao.nos[inicio + 1], dados.data() + posicoes[r], (fim - inicio - 2) * sizeof(int32_t));
+            solucao.nos[fim - 1] = 0;
+        }
+        return "";
+    }
+
+    // cabeçalho do texto: "chave valor" até a linha "rotas <n>"
+    size_t pos = 0;
+    auto proximaLinha = [&]() {
+        size_t fim = dados.find('\n', pos);
+        if (fim == std::string::npos) fim = dados.size();
+        std::string linha = dados.substr(pos, fim - pos);
+        pos = std::min(dados.size(), fim + 1);
+        return linha;
+    };
+    if (proximaLinha().rfind("vrp-solucao 1", 0) != 0) return "Cabeçalho inválido em " + arquivo;
+    bool temRotas = false;
+    while (!temRotas && pos < dados.size()) {
+        std::string linha = proximaLinha();
+        size_t espaco = linha.find(' ');
+        if (espaco == std::string::npos) return "Linha inválida no cabeçalho de " + arquivo + ": " + linha;
+        std::string chave = linha.substr(0, espaco), valor = linha.substr(espaco + 1);
+        if (chave == "programa") c.programa = valor;
+        else if (chave == "vertices") c.vertices = std::atoi(valor.c_str());
+        else if (chave == "capacidade") c.capacidade = std::atoi(valor.c_str());
+        else if (chave == "max_paradas") c.maxParadas = std::atoi(valor.c_str());
+        else if (chave == "custo") c.custo = std::atoll(valor.c_str());
+        else if (chave == "limite_atingido") c.limiteAtingido = valor == "1";
+        else if (chave == "rotas") {
+            c.rotas = std::atoll(valor.c_str());
+            temRotas = true;
+        }
+    }
+    if (!temRotas) return "Cabeçalho sem a linha 'rotas' em " + arquivo;
+
+    // trechos de tamanho parecido, terminados em fim de linha
+    int numTrechos = 4 * std::max(1u, std::thread::hardware_concurrency());
+    std::vector<TrechoSolucao> trechos;
+    const char* atual = dados.data() + pos;
+    const char* fimDados = dados.data() + dados.size();
+    size_t passo = (fimDados - atual) / numTrechos + 1;
+    while (atual < fimDados) {
+        const char* fim = atual + std::min<size_t>(passo, fimDados - atual);
+        while (fim < fimDados && *(fim - 1) != '\n') fim++;
+        trechos.push_back({atual, fim, {}, {}, false});
+        atual = fim;
+    }
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (size_t t = 0; t < trechos.size(); t++) lerTrechoSolucao(trechos[t]);
+
+    std::vector<long long> primeiraRota(trechos.size() + 1, 0), primeiroNo(trechos.size() + 1, 0);
+    for (size_t t = 0; t < trechos.size(); t++) {
+        if (trechos[t].invalido) return "Número inválido nas rotas de " + arquivo;
+        primeiraRota[t + 1] = primeiraRota[t] + trechos[t].tamanhos.size();
+        primeiroNo[t + 1] = primeiroNo[t] + trechos[t].nos.size();
+    }
+    if (primeiraRota.back() != c.rotas) {
+        return "O cabeçalho de " + arquivo + " declara " + std::to_string(c.rotas) + " rotas, mas há " + std::to_string(primeiraRota.back());
+    }
+    solucao.inicios.assign(c.rotas + 1, 0);
+    solucao.nos.resize(primeiroNo.back());
+    solucao.inicios[c.rotas] = primeiroNo.back();
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (size_t t = 0; t < trechos.size(); t++) {
+        long long no = primeiroNo[t];
+        for (size_t r = 0; r < trechos[t].tamanhos.size(); r++) {
+            solucao.inicios[primeiraRota[t] + r] = no;
+            no += trechos[t].tamanhos[r];
+        }
+        std::copy(trechos[t].nos.begin(), trechos[t].nos.end(), solucao.nos.begin() + primeiroNo[t]);
+    }
+    return "";
+}
+
+#endif
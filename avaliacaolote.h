@@ -0,0 +1,199 @@
+#ifndef AVALIACAOLOTE_H
+#define AVALIACAOLOTE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VRP_SIMD_X86 1
+#endif
+
+// Avaliação em lote do custo e da carga de muitas rotas do mesmo comprimento, com o mesmo resultado de
+// calcularCusto e verificaCapacidade (vrp.h) para cada rota.
+//
+// As rotas ficam em layout SoA (LoteRotas): a posição k de todas as rotas é contígua, então 8 (AVX2) ou
+// 16 (AVX-512) rotas avançam juntas, com um gather por arco na matriz plana e outro no vetor de demandas.
+// Arcos inexistentes e excesso de carga são acumulados em máscaras, sem desvio por rota.
+// A variante é escolhida em tempo de execução pela CPU; sem AVX2 (ou fora de x86) roda o laço escalar.
+
+enum NivelSimd { SIMD_ESCALAR, SIMD_AVX2, SIMD_AVX512 };
+
+inline const char* nomeNivelSimd(NivelSimd nivel) {
+    switch (nivel) {
+        case SIMD_AVX512: return "avx512";
+        case SIMD_AVX2: return "avx2";
+        default: return "escalar";
+    }
+}
+
+// Maior variante suportada pela CPU em que o programa está rodando
+inline NivelSimd nivelSimdDisponivel() {
+#ifdef VRP_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+#endif
+    return SIMD_ESCALAR;
+}
+
+// Matriz de distâncias (linha a linha, n x n) e demandas em blocos contíguos de int, para os gathers
+struct MatrizPlana {
+    int n = 0;
+    std::vector<int> distancias;
+    std::vector<int> demandas;
+
+    MatrizPlana() = default;   // para as réplicas por nó do modo NUMA (numa.h)
+    MatrizPlana(const std::vector<std::vector<int>>& densa, const std::vector<int>& demandasNos) : n(densa.size()) {
+        distancias.resize((size_t)n * n);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) distancias[(size_t)i * n + j] = densa[i][j];
+        }
+        demandas.assign(demandasNos.begin(), demandasNos.end());
+        demandas.resize(n, 0);
+    }
+};
+
+// Permutações avaliadas juntas na geração do conjunto de rotas: cada posição da fatia enche um lote desse tamanho
+const int PERMUTACOES_POR_LOTE = 256;
+
+// Até 'capacidade' rotas de 'comprimento' nós (depósitos incluídos), guardadas como nos[k * capacidade + r]
+struct LoteRotas {
+    int comprimento;
+    int capacidade;
+    int quantidade = 0;
+    std::vector<int> nos;
+    std::vector<int> custos;        // -1 se algum arco não existe, como calcularCusto
+    std::vector<uint8_t> viaveis;   // 1 se todos os arcos existem e a carga cabe no veículo
+
+    LoteRotas(int comprimento, int capacidade)
+        : comprimento(comprimento), capacidade(capacidade), nos((size_t)comprimento * capacidade),
+          custos(capacidade), viaveis(capacidade) {}
+
+    bool cheio() const { return quantidade == capacidade; }
+    void limpar() { quantidade = 0; }
+    int no(int rota, int posicao) const { return nos[(size_t)posicao * capacidade + rota]; }
+
+    // Acrescenta uma rota lida de 'rota' (qualquer sequência com begin/end e 'comprimento' nós)
+    template <typename Sequencia>
+    void adicionar(const Sequencia& rota) {
+        int k = 0;
+        for (int v : rota) nos[(size_t)(k++) * capacidade + quantidade] = v;
+        quantidade++;
+    }
+};
+
+// Avalia as rotas [inicio, fim) do lote sem instruções vetoriais, uma de cada vez mas sem desvio por arco
+inline void avaliarLoteEscalar(const MatrizPlana& m, LoteRotas& lote, int capacidadeVeiculo, int inicio, int fim) {
+    const int* distancias = m.distancias.data();
+    const int* demandas = m.demandas.data();
+    const int n = m.n;
+    const size_t passo = lote.capacidade;
+    const int comprimento = lote.comprimento;
+    const int* nos = lote.nos.data();
+    for (int r = inicio; r < fim; r++) {
+        const int* no = nos + r;
+        int a = no[0];
+        int custo = 0;
+        int carga = demandas[a];
+        bool invalida = false;
+        for (int k = 1; k < comprimento; k++) {
+            int b = no[k * passo];
+            int d = distancias[a * n + b];
+            invalida |= (d == 0);
+            custo += d;
+            carga += demandas[b];
+            a = b;
+        }
+        lote.custos[r] = invalida ? -1 : custo;
+        lote.viaveis[r] = !invalida && carga <= capacidadeVeiculo;
+    }
+}
+
+#ifdef VRP_SIMD_X86
+// Retorna até onde avaliou (múltiplo de 8); o resto fica para a versão escalar
+__attribute__((target("avx2")))
+inline int avaliarLoteAVX2(const MatrizPlana& m, LoteRotas& lote, int capacidadeVeiculo) {
+    const int* distancias = m.distancias.data();
+    const int* demandas = m.demandas.data();
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i vn = _mm256_set1_epi32(m.n);
+    const __m256i vcapacidade = _mm256_set1_epi32(capacidadeVeiculo);
+    const int* nos = lote.nos.data();
+    const size_t passo = lote.capacidade;
+    const int comprimento = lote.comprimento;
+    int r = 0;
+    for (; r + 8 <= lote.quantidade; r += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(nos + r));
+        __m256i custo = zero;
+        __m256i carga = _mm256_i32gather_epi32(demandas, a, 4);
+        __m256i invalida = zero;
+        for (int k = 1; k < comprimento; k++) {
+            __m256i b = _mm256_loadu_si256((const __m256i*)(nos + k * passo + r));
+            __m256i d = _mm256_i32gather_epi32(distancias, _mm256_add_epi32(_mm256_mullo_epi32(a, vn), b), 4);
+            invalida = _mm256_or_si256(invalida, _mm256_cmpeq_epi32(d, zero));
+            custo = _mm256_add_epi32(custo, d);
+            carga = _mm256_add_epi32(carga, _mm256_i32gather_epi32(demandas, b, 4));
+            a = b;
+        }
+        custo = _mm256_or_si256(custo, invalida);   // invalida tem todos os bits ligados: -1
+        __m256i inviavel = _mm256_or_si256(invalida, _mm256_cmpgt_epi32(carga, vcapacidade));
+        _mm256_storeu_si256((__m256i*)(lote.custos.data() + r), custo);
+        int mascara = _mm256_movemask_ps(_mm256_castsi256_ps(inviavel));
+        for (int i = 0; i < 8; i++) lote.viaveis[r + i] = !((mascara >> i) & 1);
+    }
+    return r;
+}
+
+__attribute__((target("avx512f")))
+inline int avaliarLoteAVX512(const MatrizPlana& m, LoteRotas& lote, int capacidadeVeiculo) {
+    const int* distancias = m.distancias.data();
+    const int* demandas = m.demandas.data();
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i vn = _mm512_set1_epi32(m.n);
+    const __m512i vcapacidade = _mm512_set1_epi32(capacidadeVeiculo);
+    const int* nos = lote.nos.data();
+    const size_t passo = lote.capacidade;
+    const int comprimento = lote.comprimento;
+    int r = 0;
+    for (; r + 16 <= lote.quantidade; r += 16) {
+        __m512i a = _mm512_loadu_si512(nos + r);
+        __m512i custo = zero;
+        __m512i carga = _mm512_mask_i32gather_epi32(zero, 0xFFFF, a, demandas, 4);
+        __mmask16 invalida = 0;
+        for (int k = 1; k < comprimento; k++) {
+            __m512i b = _mm512_loadu_si512(nos + k * passo + r);
+            __m512i d = _mm512_mask_i32gather_epi32(zero, 0xFFFF, _mm512_add_epi32(_mm512_mullo_epi32(a, vn), b), distancias, 4);
+            invalida |= _mm512_cmpeq_epi32_mask(d, zero);
+            custo = _mm512_add_epi32(custo, d);
+            carga = _mm512_add_epi32(carga, _mm512_mask_i32gather_epi32(zero, 0xFFFF, b, demandas, 4));
+            a = b;
+        }
+        custo = _mm512_mask_mov_epi32(custo, invalida, _mm512_set1_epi32(-1));
+        __mmask16 inviavel = invalida | _mm512_cmpgt_epi32_mask(carga, vcapacidade);
+        _mm512_storeu_si512(lote.custos.data() + r, custo);
+        for (int i = 0; i < 16; i++) lote.viaveis[r + i] = !((inviavel >> i) & 1);
+    }
+    return r;
+}
+#endif
+
+// Avalia todas as rotas do lote com a variante 'nivel' (limitada ao que a CPU suporta)
+inline void avaliarLote(const MatrizPlana& m, LoteRotas& lote, int capacidadeVeiculo, NivelSimd nivel) {
+    int avaliadas = 0;
+#ifdef VRP_SIMD_X86
+    static const NivelSimd disponivel = nivelSimdDisponivel();
+    if (nivel > disponivel) nivel = disponivel;
+    if (nivel == SIMD_AVX512) avaliadas = avaliarLoteAVX512(m, lote, capacidadeVeiculo);
+    else if (nivel == SIMD_AVX2) avaliadas = avaliarLoteAVX2(m, lote, capacidadeVeiculo);
+#endif
+    avaliarLoteEscalar(m, lote, capacidadeVeiculo, avaliadas, lote.quantidade);
+}
+
+inline void avaliarLote(const MatrizPlana& m, LoteRotas& lote, int capacidadeVeiculo) {
+    static const NivelSimd nivel = nivelSimdDisponivel();
+    avaliarLote(m, lote, capacidadeVeiculo, nivel);
+}
+
+#endif
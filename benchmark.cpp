@@ -0,0 +1,329 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <random>
+#include <numeric>
+#include <cmath>
+#include <chrono>
+
+#include "buscaglobal.h"
+#include "clarke.h"
+#include "greedy.h"
+#include "gerador.h"
+#include "matriz.h"
+#include "coordenadas.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Microbenchmarks dos kernels dos resolvedores.
+// Cada kernel roda 'aquecimento' rodadas descartadas e depois 'repeticoes' rodadas medidas, para cada
+// tamanho de instância e semente (as mesmas instâncias que o geraGrafo.cpp grava com a mesma semente).
+// O resultado (ns por operação: mínimo, mediana, média, desvio e p90) é gravado em JSON para ser
+// comparado entre commits com o compara_bench.py.
+
+struct Instancia {
+    vector<int> demandas;
+    vector<vector<int>> distancias;
+};
+
+// Gera em memória a mesma instância que ./geraGrafo <numNos> --semente <semente> gravaria
+Instancia gerarInstancia(int numNos, unsigned semente) {
+    ParametrosGerador p;
+    p.numNos = numNos;
+    p.semente = semente;
+
+    Instancia inst;
+    inst.demandas.assign(numNos, 0);
+    inst.distancias.assign(numNos, vector<int>(numNos, 0));
+    for (int i = 1; i < numNos; i++) {
+        inst.demandas[i] = demandaDoNo(p, i);
+        inst.distancias[0][i] = pesoDoDeposito(p, i);
+        inst.distancias[i][0] = inst.distancias[0][i];
+        for (int j = i + 1; j < numNos; j++) {
+            inst.distancias[i][j] = pesoDoArco(p, i, j);
+        }
+    }
+    return inst;
+}
+
+// Rotas aleatórias 0 a b c ... 0 com 'paradas' clientes distintos
+vector<vector<int>> gerarRotasAleatorias(int numNos, int paradas, int quantidade, mt19937& gerador) {
+    vector<int> clientes(numNos - 1);
+    iota(clientes.begin(), clientes.end(), 1);
+    paradas = min(paradas, numNos - 1);
+
+    vector<vector<int>> rotas;
+    for (int r = 0; r < quantidade; r++) {
+        shuffle(clientes.begin(), clientes.end(), gerador);
+        vector<int> rota = {0};
+        rota.insert(rota.end(), clientes.begin(), clientes.begin() + paradas);
+        rota.push_back(0);
+        rotas.push_back(rota);
+    }
+    return rotas;
+}
+
+// Itinerários aleatórios que cobrem todos os clientes, cortados em rotas de até 'paradas' clientes
+vector<vector<vector<int>>> gerarItinerariosAleatorios(int numNos, int paradas, int quantidade, mt19937& gerador) {
+    vector<int> clientes(numNos - 1);
+    iota(clientes.begin(), clientes.end(), 1);
+
+    vector<vector<vector<int>>> itinerarios;
+    for (int r = 0; r < quantidade; r++) {
+        shuffle(clientes.begin(), clientes.end(), gerador);
+        vector<vector<int>> itinerario;
+        for (size_t i = 0; i < clientes.size(); i += paradas) {
+            size_t j = min(i + paradas, clientes.size());
+            vector<int> rota = {0};
+            rota.insert(rota.end(), clientes.begin() + i, clientes.begin() + j);
+            rota.push_back(0);
+            itinerario.push_back(rota);
+        }
+        itinerarios.push_back(itinerario);
+    }
+    return itinerarios;
+}
+
+struct Estatisticas {
+    double minimo, mediana, media, desvio, p90;
+};
+
+Estatisticas resumir(vector<double> amostras) {
+    sort(amostras.begin(), amostras.end());
+    size_t n = amostras.size();
+    Estatisticas e;
+    e.minimo = amostras.front();
+    e.mediana = (n % 2 == 1) ? amostras[n / 2] : (amostras[n / 2 - 1] + amostras[n / 2]) / 2.0;
+    e.media = accumulate(amostras.begin(), amostras.end(), 0.0) / n;
+    double soma = 0;
+    for (double a : amostras) soma += (a - e.media) * (a - e.media);
+    e.desvio = n > 1 ? sqrt(soma / (n - 1)) : 0.0;
+    e.p90 = amostras[min(n - 1, (size_t)ceil(0.9 * n) - 1)];
+    return e;
+}
+
+// Evita que o compilador descarte o resultado dos kernels
+volatile long long sumidouro = 0;
+
+// Executa a rodada 'aquecimento' vezes sem medir e 'repeticoes' vezes medindo; devolve ns por operação de cada rodada.
+// A função recebe o número de operações da rodada e retorna um valor qualquer que é acumulado no sumidouro.
+template <typename Funcao>
+vector<double> medir(Funcao rodada, long long opsPorRodada, int aquecimento, int repeticoes) {
+    for (int i = 0; i < aquecimento; i++) {
+        sumidouro += rodada();
+    }
+    vector<double> amostras;
+    for (int i = 0; i < repeticoes; i++) {
+        auto inicio = steady_clock::now();
+        sumidouro += rodada();
+        auto fim = steady_clock::now();
+        amostras.push_back(duration_cast<nanoseconds>(fim - inicio).count() / (double)opsPorRodada);
+    }
+    return amostras;
+}
+
+struct Resultado {
+    string kernel;
+    int nos;
+    unsigned semente;
+    long long opsPorRodada;
+    Estatisticas ns;
+};
+
+vector<int> lerLista(const string& texto) {
+    vector<int> valores;
+    stringstream ss(texto);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) valores.push_back(stoi(item));
+    }
+    return valores;
+}
+
+int main(int argc, char* argv[]) {
+    vector<int> tamanhos = {8, 64, 256, 1024};
+    vector<int> sementes = {1, 2, 3};
+    int repeticoes = 15;
+    int aquecimento = 3;
+    int maxNosPool = 8;         // a geração do conjunto de rotas é fatorial no número de nós
+    int capacidade = 15;
+    int maxParadas = 5;
+    string saida = "bench.json";
+
+    for (int i = 1; i < argc; i++) {
+        string opcao = argv[i];
+        if (i + 1 >= argc) break;
+        if (opcao == "--tamanhos") tamanhos = lerLista(argv[++i]);
+        else if (opcao == "--sementes") sementes = lerLista(argv[++i]);
+        else if (opcao == "--repeticoes") repeticoes = max(1, atoi(argv[++i]));
+        else if (opcao == "--aquecimento") aquecimento = atoi(argv[++i]);
+        else if (opcao == "--max-nos-pool") maxNosPool = atoi(argv[++i]);
+        else if (opcao == "--saida") saida = argv[++i];
+    }
+
+    vector<Resultado> resultados;
+    auto registrar = [&](const string& kernel, int nos, unsigned semente, long long ops, const vector<double>& amostras) {
+        Resultado r{kernel, nos, semente, ops, resumir(amostras)};
+        resultados.push_back(r);
+        cout << kernel << " n=" << nos << " semente=" << semente << ": mediana " << r.ns.mediana << " ns/op (desvio " << r.ns.desvio << ")" << endl;
+    };
+
+    for (int n : tamanhos) {
+        if (n < 2) continue;
+        for (int semente : sementes) {
+            Instancia inst = gerarInstancia(n, semente);
+            mt19937 gerador(semente);
+            LimitesExecucao semLimites;
+
+            const int numRotas = 4096;
+            vector<vector<int>> rotas = gerarRotasAleatorias(n, maxParadas - 2, numRotas, gerador);
+
+            registrar("calcularCusto", n, semente, numRotas, medir([&]() {
+                long long soma = 0;
+                for (const auto& rota : rotas) soma += calcularCusto(rota, inst.distancias);
+                return soma;
+            }, numRotas, aquecimento, repeticoes));
+
+            registrar("verificaCapacidade", n, semente, numRotas, medir([&]() {
+                long long soma = 0;
+                for (const auto& rota : rotas) soma += verificaCapacidade(rota, inst.demandas, capacidade);
+                return soma;
+            }, numRotas, aquecimento, repeticoes));
+
+            // as duas verificações juntas, rota a rota e em lote (avaliacaolote.h) em cada variante suportada pela CPU
+            registrar("custoECapacidade", n, semente, numRotas, medir([&]() {
+                long long soma = 0;
+                for (const auto& rota : rotas) {
+                    soma += calcularCusto(rota, inst.distancias) != -1 && verificaCapacidade(rota, inst.demandas, capacidade) == 1;
+                }
+                return soma;
+            }, numRotas, aquecimento, repeticoes));
+
+            // lotes do tamanho usado na geração do conjunto de rotas (PERMUTACOES_POR_LOTE)
+            MatrizPlana plana(inst.distancias, inst.demandas);
+            vector<LoteRotas> lotes;
+            for (const auto& rota : rotas) {
+                if (lotes.empty() || lotes.back().cheio()) lotes.emplace_back(rota.size(), PERMUTACOES_POR_LOTE);
+                lotes.back().adicionar(rota);
+            }
+            for (int nivel = SIMD_ESCALAR; nivel <= nivelSimdDisponivel(); nivel++) {
+                registrar(string("avaliarLote_") + nomeNivelSimd((NivelSimd)nivel), n, semente, numRotas, medir([&]() {
+                    long long soma = 0;
+                    for (LoteRotas& lote : lotes) {
+                        avaliarLote(plana, lote, capacidade, (NivelSimd)nivel);
+                        soma += lote.custos[0];
+                    }
+                    return soma;
+                }, numRotas, aquecimento, repeticoes));
+            }
+
+            const int numItinerarios = 256;
+            auto itinerarios = gerarItinerariosAleatorios(n, maxParadas - 2, numItinerarios, gerador);
+            registrar("checkAllNodesWithoutOverlap", n, semente, numItinerarios, medir([&]() {
+                long long soma = 0;
+                for (const auto& itinerario : itinerarios) soma += checkAllNodesWithoutOverlap(itinerario, n);
+                return soma;
+            }, numItinerarios, aquecimento, repeticoes));
+
+            if (n <= maxNosPool) {
+                vector<int> demandas = inst.demandas;
+                registrar("geracaoRotas", n, semente, 1, medir([&]() {
+                    vector<vector<int>> rotas_possiveis;
+                    for (int num_cidades = 1; num_cidades < maxParadas - 1; num_cidades++) {
+                        GerarTodasAsCombinacoesPossiveis<vector<int>>(inst.distancias, num_cidades, rotas_possiveis, demandas, capacidade, semLimites);
+                    }
+                    return (long long)rotas_possiveis.size();
+                }, 1, aquecimento, repeticoes));
+                registrar("geracaoRotas_fixa", n, semente, 1, medir([&]() {
+                    return (long long)gerarRotasPossiveisCom<RotaFixa<5>>(inst.distancias, demandas, capacidade, maxParadas, semLimites).size();
+                }, 1, aquecimento, repeticoes));
+            }
+
+            registrar("calcularEconomias", n, semente, 1, medir([&]() {
+                return (long long)calcularEconomias(inst.distancias).size();
+            }, 1, aquecimento, repeticoes));
+
+            registrar("insercaoMaisProxima", n, semente, 1, medir([&]() {
+                return (long long)insercaoMaisProxima(inst.distancias, inst.demandas, capacidade, semLimites).size();
+            }, 1, aquecimento, repeticoes));
+
+            // reordenação exata (Held-Karp) das rotas da inserção mais próxima, por rota
+            vector<vector<int>> rotasInsercao = insercaoMaisProxima(inst.distancias, inst.demandas, capacidade, semLimites);
+            registrar("reordenarRotas", n, semente, rotasInsercao.size(), medir([&]() {
+                vector<vector<int>> rotas = rotasInsercao;
+                return reordenarRotas(rotas, inst.distancias);
+            }, rotasInsercao.size(), aquecimento, repeticoes));
+
+            // as mesmas heurísticas sobre a matriz compacta (matriz.h), e sobre a instância simetrizada no formato triangular
+            vector<vector<int>> simetrica = inst.distancias;
+            for (int i = 0; i < n; i++) {
+                for (int j = i + 1; j < n; j++) simetrica[j][i] = simetrica[i][j];
+            }
+            for (const auto& [sufixo, matriz] : {make_pair(string("_compacta"), &inst.distancias), make_pair(string("_triangular"), &simetrica)}) {
+                comMatrizCompacta(*matriz, [&](const auto& compacta) {
+                    registrar("calcularEconomias" + sufixo, n, semente, 1, medir([&]() {
+                        return (long long)calcularEconomias(compacta).size();
+                    }, 1, aquecimento, repeticoes));
+                    registrar("insercaoMaisProxima" + sufixo, n, semente, 1, medir([&]() {
+                        return (long long)insercaoMaisProxima(compacta, inst.demandas, capacidade, semLimites).size();
+                    }, 1, aquecimento, repeticoes));
+                    return 0;
+                });
+            }
+
+            // instância com coordenadas (coordenadas.h): distâncias uma a uma e linhas inteiras, por distância calculada
+            ParametrosGerador parametros;
+            parametros.numNos = n;
+            parametros.semente = semente;
+            vector<double> x(n), y(n);
+            for (int i = 0; i < n; i++) {
+                x[i] = coordenadaDoNo(parametros, i, 0);
+                y[i] = coordenadaDoNo(parametros, i, 1);
+            }
+            MatrizCoordenadas coordenadas(x, y, METRICA_EUCLIDIANA);
+            registrar("distanciaCoordenadas", n, semente, (long long)n * n, medir([&]() {
+                long long soma = 0;
+                for (int i = 0; i < n; i++) {
+                    for (int j = 0; j < n; j++) soma += coordenadas.distancia(i, j);
+                }
+                return soma;
+            }, (long long)n * n, aquecimento, repeticoes));
+            vector<int> linha(n);
+            registrar("linhaCoordenadas", n, semente, (long long)n * n, medir([&]() {
+                long long soma = 0;
+                for (int i = 0; i < n; i++) {
+                    coordenadas.calcularLinha(i, linha.data());
+                    soma += linha[n - 1];
+                }
+                return soma;
+            }, (long long)n * n, aquecimento, repeticoes));
+            coordenadas.usarCacheDeLinhas(8);
+            registrar("insercaoMaisProxima_coordenadas", n, semente, 1, medir([&]() {
+                return (long long)insercaoMaisProxima(coordenadas, inst.demandas, capacidade, semLimites).size();
+            }, 1, aquecimento, repeticoes));
+        }
+    }
+
+    ofstream arquivo(saida);
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo " << saida << endl;
+        return 1;
+    }
+    arquivo << "{\n  \"config\": {\"aquecimento\": " << aquecimento << ", \"repeticoes\": " << repeticoes
+            << ", \"capacidade\": " << capacidade << ", \"maxParadas\": " << maxParadas << "},\n  \"resultados\": [\n";
+    for (size_t i = 0; i < resultados.size(); i++) {
+        const Resultado& r = resultados[i];
+        arquivo << "    {\"kernel\": \"" << r.kernel << "\", \"nos\": " << r.nos << ", \"semente\": " << r.semente
+                << ", \"ops_por_rodada\": " << r.opsPorRodada << ", \"ns_por_op\": {\"min\": " << r.ns.minimo
+                << ", \"mediana\": " << r.ns.mediana << ", \"media\": " << r.ns.media << ", \"desvio\": " << r.ns.desvio
+                << ", \"p90\": " << r.ns.p90 << "}}" << (i + 1 < resultados.size() ? "," : "") << "\n";
+    }
+    arquivo << "  ]\n}\n";
+    cout << "Resultados gravados em " << saida << endl;
+
+    return 0;
+}
@@ -0,0 +1,265 @@
+#ifndef BUSCAGLOBAL_H
+#define BUSCAGLOBAL_H
+
+#include "vrp.h"
+#include "limitantes.h"
+
+// Busca global (força bruta) sequencial: geração do conjunto de rotas e enumeração dos itinerários, cada um
+// avaliado uma única vez ao ser completado. As rotas de cada fatia são montadas como RotaFixa<maxParadas>
+// (rotafixa.h) nos valores usuais de maxParadas, para que os laços internos não aloquem memória, e como
+// vector<int> nos demais. O conjunto de rotas fica em PoolSequencias (poolrotas.h): uma arena única, com
+// deduplicação por hash.
+
+// Função para gerar todas as combinações possíveis de rotas válidas independente do custo.
+// 'resultados' pode ser um vector de rotas ou um PoolSequencias.
+// As fatias de PERMUTACOES_POR_LOTE permutações são avaliadas juntas (avaliacaolote.h), um lote por posição da fatia,
+// e depois aceitas na mesma ordem em que a versão rota a rota as aceitaria.
+
+template <typename Rota, typename Resultados>
+inline void GerarTodasAsCombinacoesPossiveis(const vector<vector<int>>& rotas, int num_cidades, Resultados& resultados,
+                                        const vector<int>& demandas, int capacidadeVeiculo, LimitesExecucao& limites) {
+    int n = rotas.size();
+    vector<int> indices;
+    for (int i = 0; i < n; ++i) {
+        indices.push_back(i);
+    }
+    MatrizPlana matriz(rotas, demandas);
+    // Aqui, você precisa dividir a permutação em várias rotas que respeitem a num_cidades do veículo
+    // vamos assumir que cada rota pode ter até 'num_cidades' locais; cada fatia tem o seu lote, todas as rotas de um lote têm o mesmo comprimento
+    vector<LoteRotas> lotes;
+    for (int i = 0; i < n; i += num_cidades) {
+        lotes.emplace_back(min(num_cidades, n - i) + 2, PERMUTACOES_POR_LOTE);
+    }
+    Rota sub;   // reaproveitada a cada rota aceita: com vector<int> a memória é alocada uma vez só
+
+    // Verifica as rotas acumuladas - rota deve existir, não deve ser repetida e a capacidade do veículo deve ser respeitada
+    auto esvaziarLotes = [&]() {
+        for (LoteRotas& lote : lotes) avaliarLote(matriz, lote, capacidadeVeiculo);
+        for (int p = 0; p < lotes[0].quantidade; p++) {
+            for (const LoteRotas& lote : lotes) {
+                if (!lote.viaveis[p]) continue;
+                sub.clear();
+                for (int k = 0; k < lote.comprimento; k++) sub.push_back(lote.no(p, k));
+                if (adicionarRotaSeNova(resultados, sub)) {
+                    contar(ROTAS_ACEITAS);
+                } else {
+                    contar(DUPLICATAS_REJEITADAS);
+                }
+            }
+        }
+        for (LoteRotas& lote : lotes) lote.limpar();
+    };
+
+    // Gera todas as permutações possíveis
+    do {
+        contar(PERMUTACOES_VISITADAS);
+        for (size_t s = 0; s < lotes.size(); s++) {
+            // Insere o depósito (assumindo ser o local 0) no início e no fim da rota
+            LoteRotas& lote = lotes[s];
+            int i = s * num_cidades;
+            int* coluna = lote.nos.data() + lote.quantidade;
+            coluna[0] = 0;
+            for (int k = 1; k < lote.comprimento - 1; k++) {
+                coluna[(size_t)k * lote.capacidade] = indices[i + k - 1];
+            }
+            coluna[(size_t)(lote.comprimento - 1) * lote.capacidade] = 0;
+            lote.quantidade++;
+        }
+        if (lotes[0].cheio()) esvaziarLotes();
+    } while (!limites.parar() && next_permutation(indices.begin() + 1, indices.end()));  // Ignora permutar o depósito; a primeira permutação sempre é avaliada
+    esvaziarLotes();
+}
+
+// Converte as rotas de um itinerário para o formato da solução (só quando ele melhora a incumbente)
+template <typename Combinacao>
+inline vector<vector<int>> rotasDoItinerario(const Combinacao& combinacao, const PoolSequencias& rotas) {
+    vector<vector<int>> itinerario;
+    for (int local : combinacao) {
+        itinerario.push_back(paraVetor(rotas[local]));
+    }
+    return itinerario;
+}
+
+// Memória reaproveitada pela enumeração dos itinerários e estado da poda por limitante (limitantes.h):
+// quantas rotas escolhidas passam por cada nó, o custo delas e um limitante do custo do que falta cobrir
+struct AreaEnumeracao {
+    vector<int> combinacaoAtual;
+    vector<unsigned> marcas;
+    unsigned carimbo = 0;
+
+    vector<int> custosRotas;        // custo de cada rota do conjunto
+    vector<long long> menorSaida;   // arco de saída mais barato de cada cliente
+    long long menorSaidaDeposito = 0;
+    vector<int> usos;
+    int sobreposicoes = 0;          // nós em mais de uma rota escolhida: nenhum itinerário a partir daqui é válido
+    long long custoParcial = 0;
+    long long faltaCobrir = 0;      // soma de menorSaida dos clientes ainda não cobertos
+    long long limitanteGlobal = 0;  // nenhum itinerário custa menos que isso: ao alcançá-lo a busca termina
+};
+
+inline void prepararPoda(AreaEnumeracao& area, const PoolSequencias& rotas, const vector<vector<int>>& locais, int numVertices, long long limitante) {
+    const long long SEM_SAIDA = INT_MAX;    // cliente que nenhuma rota válida atende
+    area.custosRotas.resize(rotas.size());
+    for (uint32_t id = 0; id < rotas.size(); id++) {
+        area.custosRotas[id] = max(0, calcularCusto(rotas[id], locais));
+    }
+    area.menorSaida.assign(numVertices, 0);
+    area.faltaCobrir = 0;
+    area.menorSaidaDeposito = SEM_SAIDA;
+    for (int i = 0; i < numVertices; i++) {
+        long long menor = SEM_SAIDA;
+        for (int j = 0; j < numVertices; j++) {
+            if (j != i && locais[i][j] != 0) menor = min<long long>(menor, locais[i][j]);
+        }
+        if (i == 0) {
+            area.menorSaidaDeposito = menor;
+        } else {
+            area.menorSaida[i] = menor;
+            area.faltaCobrir += menor;
+        }
+    }
+    area.usos.assign(numVertices, 0);
+    area.sobreposicoes = 0;
+    area.custoParcial = 0;
+    area.limitanteGlobal = limitante;
+}
+
+inline void escolherRota(AreaEnumeracao& area, const PoolSequencias& rotas, int id) {
+    area.combinacaoAtual.push_back(id);
+    area.custoParcial += area.custosRotas[id];
+    for (int no : rotas[id]) {
+        if (no == 0) continue;
+        if (area.usos[no]++ == 0) area.faltaCobrir -= area.menorSaida[no];
+        else area.sobreposicoes++;
+    }
+}
+
+inline void desfazerRota(AreaEnumeracao& area, const PoolSequencias& rotas, int id) {
+    area.combinacaoAtual.pop_back();
+    area.custoParcial -= area.custosRotas[id];
+    for (int no : rotas[id]) {
+        if (no == 0) continue;
+        if (--area.usos[no] == 0) area.faltaCobrir += area.menorSaida[no];
+        else area.sobreposicoes--;
+    }
+}
+
+// Função recursiva para gerar todas as combinações de rotas. Cada itinerário completo é avaliado e oferecido à
+// incumbente assim que é encontrado (uma única vez), para que a poda use a melhor solução desde o início
+inline void gerarCombinacoesRecursivo(const PoolSequencias& rotas, AreaEnumeracao& area,
+int tamanho_itinerario, int numVertices, int inicio, const vector<vector<int>>& locais, LimitesExecucao& limites, Incumbente& incumbente) {
+    if (limites.parar()) return;
+    if (incumbente.custo <= area.limitanteGlobal) return;   // a incumbente já é ótima
+    contar(COMBINACOES_VISITADAS);
+    vector<int>& combinacaoAtual = area.combinacaoAtual;
+
+    // Verifica se a combinação atual contém todas as rotas
+    if (combinacaoAtual.size() == tamanho_itinerario) {
+        if (cobreTodosOsNos(combinacaoAtual, rotas, numVertices, area.marcas, area.carimbo)){
+            contar(ITINERARIOS_AVALIADOS);
+            int custo = calculaCustoTotal(combinacaoAtual, rotas, locais);
+            if (custo != -1 && custo < incumbente.custo) {
+                incumbente.oferecer(custo, rotasDoItinerario(combinacaoAtual, rotas), limites);
+            }
+        } else {
+            contar(COMBINACOES_PODADAS);
+        }
+        return;
+    }
+
+    // Tenta adicionar cada rota que ainda não foi usada, podando quando há nós repetidos ou quando nem o custo mínimo
+    // do que falta (a saída mais barata de cada cliente não coberto e do depósito em cada rota restante) melhora a incumbente
+    long long rotasRestantes = tamanho_itinerario - combinacaoAtual.size() - 1;
+    for (size_t i = inicio; i < rotas.size(); i++) {
+        escolherRota(area, rotas, i);
+        if (area.sobreposicoes == 0 &&
+            area.custoParcial + area.faltaCobrir + rotasRestantes * area.menorSaidaDeposito < incumbente.custo) {
+            gerarCombinacoesRecursivo(rotas, area, tamanho_itinerario, numVertices, i + 1, locais, limites, incumbente);
+        } else {
+            contar(COMBINACOES_PODADAS);
+        }
+        desfazerRota(area, rotas, i);
+    }
+}
+
+// Enumera os itinerários de todos os tamanhos e deixa o de menor custo em 'incumbente'.
+// 'limitante' é um limitante inferior do custo de qualquer itinerário (0 se desconhecido)
+inline int enumerarItinerarios(const PoolSequencias& rotas, int numVertices, const vector<vector<int>>& locais,
+                               LimitesExecucao& limites, Incumbente& incumbente, long long limitante = 0) {
+    AreaEnumeracao area;
+    area.combinacaoAtual.reserve(rotas.size());
+    prepararPoda(area, rotas, locais, numVertices, limitante);
+
+    // Esse loop garante que as combinações tenham todos os tamanhos possíveis
+    for (uint32_t k = 1; k <= rotas.size() && !limites.tempoEsgotado(); k++){
+        gerarCombinacoesRecursivo(rotas, area, k, numVertices, 0, locais, limites, incumbente);
+    }
+
+    return incumbente.custo;
+}
+
+// Gera todas as rotas viáveis com até maxParadas-2 clientes (o conjunto de rotas da busca global), montando as fatias como 'Rota'
+template <typename Rota>
+inline PoolSequencias gerarRotasPossiveisCom(const vector<vector<int>>& locais, const vector<int>& demandas, int C, int maxParadas, LimitesExecucao& limites) {
+    FaseCronometrada fase("geracao_rotas");
+    PoolSequencias rotas_possiveis;
+    for (int num_cidades = 1; num_cidades < maxParadas-1; num_cidades++){   // Neste caso, "num_cidades" sao quantos nos podem ter em uma rota
+        GerarTodasAsCombinacoesPossiveis<Rota>(locais, num_cidades, rotas_possiveis, demandas, C, limites);  // itera sob todas as possibilidades de rota e adiciona a rotas_possiveis
+    }
+    return rotas_possiveis;
+}
+
+// Idem, com RotaFixa<maxParadas> quando há instanciação para esse maxParadas
+inline PoolSequencias gerarRotasPossiveis(const vector<vector<int>>& locais, const vector<int>& demandas, int C, int maxParadas, LimitesExecucao& limites) {
+    return despacharMaxParadas(maxParadas, [&](auto paradas) {
+        constexpr int M = decltype(paradas)::value;
+        using Rota = conditional_t<M == 0, vector<int>, RotaFixa<M == 0 ? 1 : M>>;
+        return gerarRotasPossiveisCom<Rota>(locais, demandas, C, maxParadas, limites);
+    });
+}
+
+// Enumeração e custo dos itinerários sobre um conjunto de rotas já gerado
+inline int buscaGlobalSobreRotas(const PoolSequencias& rotas_possiveis, const vector<vector<int>>& locais, int numVertices,
+                                 LimitesExecucao& limites, Incumbente& incumbente, long long limitante = 0) {
+    FaseCronometrada fase("enumeracao_itinerarios");
+    return enumerarItinerarios(rotas_possiveis, numVertices, locais, limites, incumbente, limitante);
+}
+
+// Executa as etapas da busca global (rotas e itinerários) e deixa a melhor solução em 'incumbente', sem imprimir nada.
+// 'rotasPrecalculadas' permite reaproveitar o conjunto de rotas de uma resolução anterior com os mesmos C e maxParadas.
+inline int buscaGlobal(const vector<vector<int>>& locais, const vector<int>& demandas, int C, int numVertices, int maxParadas,
+                       LimitesExecucao& limites, Incumbente& incumbente, const PoolSequencias* rotasPrecalculadas = nullptr) {
+    oferecerRotasIndividuais(locais, demandas, C, numVertices, limites, incumbente);
+    Limitante limitante = calcularLimitante(locais, demandas, C, maxParadas - 2);
+
+    // Gera todas as combinações possíveis de rotas de todos os tamanhos
+    if (rotasPrecalculadas) {
+        return buscaGlobalSobreRotas(*rotasPrecalculadas, locais, numVertices, limites, incumbente, limitante.valor);
+    }
+    PoolSequencias rotas_possiveis = gerarRotasPossiveis(locais, demandas, C, maxParadas, limites);
+    return buscaGlobalSobreRotas(rotas_possiveis, locais, numVertices, limites, incumbente, limitante.valor);
+}
+
+inline int ResolverVRPComDemanda(vector<vector<int>> locais, vector<int> demandas, int C, int& numVertices, LimitesExecucao& limites,
+                                 vector<vector<int>>* rotasSaida = nullptr){
+    int maxParadas = 5;
+    Incumbente incumbente;
+    int menorCusto = buscaGlobal(locais, demandas, C, numVertices, maxParadas, limites, incumbente);
+
+    if (limites.esgotado) {
+        cout << "Limite de execução atingido, exibindo a melhor solução encontrada" << endl;
+    }
+    // com o limite atingido antes da primeira solução viável a incumbente fica vazia
+    cout << (incumbente.existe() ? to_string(menorCusto) : "Nenhuma solução encontrada") << endl;
+    for (const auto& rota : incumbente.rotas) {
+        for (int local : rota) {
+            cout << local << " ";
+        }
+        cout << "| ";
+    }
+
+    if (rotasSaida) *rotasSaida = incumbente.rotas;
+    return menorCusto;
+}
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "gerador.h"
+#include "instrumentacao.h"
+
+// Cache persistente de soluções em disco (--cache <diretório>), para instâncias resolvidas mais de uma vez
+// (o mesmo dia de um depósito rodado por várias equipes, tarefas repetidas depois de uma falha).
+//
+// A chave é um hash de 64 bits do conteúdo da instância (demandas e matriz de arcos) e dos parâmetros que mudam
+// o resultado: capacidade, maxParadas, resolvedor e, no portfolio, a tolerância de gap. Os resolvedores são
+// determinísticos, então não há semente na chave. Cada instância tem dois tipos de registro:
+//   <chave do pedido>.sol    a solução do resolvedor e o limitante. Se ela foi obtida sem atingir um limite de
+//                            execução, um pedido igual é respondido direto do arquivo.
+//   <chave da instância>.melhor   a melhor solução viável conhecida para (instância, capacidade, maxParadas), de
+//                            qualquer resolvedor: ponto de partida da busca global e do portfolio (resolvedores.h).
+// Os registros são gravados num arquivo temporário e renomeados, então processos e threads concorrentes nunca
+// leem um registro pela metade; a chave e os nós são conferidos na leitura, e a solução de um .sol só é usada se
+// for viável e tiver o custo registrado (um registro corrompido ou de uma colisão de chave conta como falta).
+
+struct CacheSolucoes {
+    std::string diretorio;          // vazio: cache desativado
+    std::atomic<long long> acertos{0};
+    std::atomic<long long> faltas{0};
+    std::atomic<long long> gravacoes{0};
+};
+
+inline CacheSolucoes& cacheSolucoes() {
+    static CacheSolucoes cache;
+    return cache;
+}
+
+inline bool cacheAtivo() {
+    return !cacheSolucoes().diretorio.empty();
+}
+
+// Acertos, faltas e gravações na seção "cache" do --estatisticas
+inline void registrarEstatisticasCache() {
+    CacheSolucoes& cache = cacheSolucoes();
+    registrarSecaoInstrumentacao("cache", "{\"acertos\": " + std::to_string(cache.acertos.load()) + ", \"faltas\": " +
+                                 std::to_string(cache.faltas.load()) + ", \"gravacoes\": " + std::to_string(cache.gravacoes.load()) + "}");
+}
+
+// --cache <diretório>; o diretório é criado se não existir
+inline void LerCache(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--cache") {
+            cacheSolucoes().diretorio = argv[i + 1];
+            std::error_code erro;
+            std::filesystem::create_directories(cacheSolucoes().diretorio, erro);
+            if (instrumentacaoAtiva()) std::atexit(registrarEstatisticasCache);
+        }
+    }
+}
+
+// Hash de uma sequência de inteiros, dois por palavra de 64 bits (multiplicação e rotação, como no wyhash/xxh3)
+inline uint64_t acumularHash(uint64_t hash, const int* valores, size_t quantidade) {
+    const uint64_t primo = 0x9E3779B97F4A7C15ULL;
+    size_t i = 0;
+    for (; i + 1 < quantidade; i += 2) {
+        uint64_t palavra = (uint64_t)(uint32_t)valores[i] | ((uint64_t)(uint32_t)valores[i + 1] << 32);
+        hash = ((hash ^ palavra) * primo);
+        hash ^= hash >> 29;
+    }
+    if (i < quantidade) hash = (hash ^ (uint32_t)valores[i]) * primo;
+    return misturarBits(hash ^ quantidade);
+}
+
+// Hash do conteúdo da instância (demandas e matriz de arcos): a parte O(n²) da chave, que o servidor calcula uma
+// vez por instância carregada (EstruturasDerivadas, resolvedores.h)
+template <typename Matriz>
+inline uint64_t chaveConteudoInstancia(const std::vector<int>& demandas, const Matriz& distancias) {
+    int vertices = distancias.size();
+    uint64_t hash = acumularHash(0, &vertices, 1);
+    hash = acumularHash(hash, demandas.data(), demandas.size());
+    for (size_t i = 0; i < distancias.size(); i++) {
+        hash = acumularHash(hash, &distancias[i][0], distancias.size());
+    }
+    return hash;
+}
+
+// Chave da instância com a capacidade e o maxParadas
+inline uint64_t chaveInstancia(uint64_t conteudo, int capacidade, int maxParadas) {
+    int parametros[2] = {capacidade, maxParadas};
+    return acumularHash(conteudo, parametros, 2);
+}
+
+// Chave de um pedido: a da instância com o resolvedor (e o que mais mudar o resultado dele)
+inline uint64_t chavePedido(uint64_t instancia, const std::string& resolvedor, double toleranciaGap) {
+    std::vector<int> texto(resolvedor.begin(), resolvedor.end());
+    uint64_t hash = acumularHash(instancia, texto.data(), texto.size());
+    if (resolvedor == "portfolio") {
+        int milesimos = (int)(toleranciaGap * 1000);
+        hash = acumularHash(hash, &milesimos, 1);
+    }
+    return hash;
+}
+
+struct RegistroCache {
+    int custo = -1;
+    long long limitante = -1;
+    bool limiteAtingido = false;
+    std::string resolvedor;         // quem produziu a solução (no portfolio, a etapa vencedora)
+    std::vector<std::vector<int>> rotas;
+};
+
+inline std::string arquivoCache(uint64_t chave, const char* extensao) {
+    char nome[32];
+    std::snprintf(nome, sizeof(nome), "%016llx.%s", (unsigned long long)chave, extensao);
+    return (std::filesystem::path(cacheSolucoes().diretorio) / nome).string();
+}
+
+// Formato (texto):
+//   vrp-cache 1 <chave> <vértices>
+//   <custo> <limitante> <limite atingido 0/1> <resolvedor>
+//   <número de rotas>
+//   uma rota por linha: <tamanho> <nós...>
+inline bool lerRegistroCache(const std::string& arquivo, uint64_t chave, int numVertices, RegistroCache& registro) {
+    std::ifstream entrada(arquivo);
+    if (!entrada.is_open()) return false;
+    std::string marca;
+    int versao, vertices;
+    unsigned long long chaveLida;
+    size_t numRotas;
+    if (!(entrada >> marca >> versao >> std::hex >> chaveLida >> std::dec >> vertices) || marca != "vrp-cache" || versao != 1 ||
+        chaveLida != chave || vertices != numVertices) {
+        return false;
+    }
+    if (!(entrada >> registro.custo >> registro.limitante >> registro.limiteAtingido >> registro.resolvedor >> numRotas) ||
+        numRotas > (size_t)numVertices) {
+        return false;
+    }
+    registro.rotas.assign(numRotas, {});
+    for (auto& rota : registro.rotas) {
+        size_t tamanho;
+        if (!(entrada >> tamanho) || tamanho > (size_t)numVertices + 2) return false;
+        rota.resize(tamanho);
+        for (int& no : rota) {
+            if (!(entrada >> no) || no < 0 || no >= numVertices) return false;
+        }
+    }
+    return true;
+}
+
+inline void gravarRegistroCache(const std::string& arquivo, uint64_t chave, int numVertices, const RegistroCache& registro) {
+    std::ostringstream texto;
+    texto << "vrp-cache 1 " << std::hex << chave << std::dec << " " << numVertices << "\n"
+          << registro.custo << " " << registro.limitante << " " << registro.limiteAtingido << " " << registro.resolvedor << "\n"
+          << registro.rotas.size() << "\n";
+    for (const auto& rota : registro.rotas) {
+        texto << rota.size();
+        for (int no : rota) texto << " " << no;
+        texto << "\n";
+    }
+
+    // nome temporário único por processo e thread; o rename substitui o registro de uma vez
+    static std::atomic<long long> sequencia{0};
+    std::string temporario = arquivo + ".tmp" + std::to_string(getpid()) + "." + std::to_string(sequencia++);
+    {
+        std::ofstream saida(temporario);
+        if (!saida.is_open() || !(saida << texto.str()) || !saida.flush()) {
+            std::remove(temporario.c_str());
+            return;
+        }
+    }
+    if (std::rename(temporario.c_str(), arquivo.c_str()) != 0) {
+        std::remove(temporario.c_str());
+        return;
+    }
+    cacheSolucoes().gravacoes++;
+}
+
+#endif
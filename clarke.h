@@ -0,0 +1,188 @@
+#ifndef CLARKE_H
+#define CLARKE_H
+
+#include "vrp.h"
+#include "reordenacao.h"
+
+// Heurística de Clarke e Wright (economias)
+
+struct Economia {
+    int i, j;
+    double valor;
+    Economia(int i, int j, double valor) : i(i), j(j), valor(valor) {}
+};
+
+inline bool compararEconomias(const Economia& a, const Economia& b) {
+    return a.valor > b.valor;
+}
+
+// Calcula as economias s(i,j) = d(0,i) + d(0,j) - d(i,j) de todos os pares de clientes, em ordem decrescente
+template <typename Matriz>
+inline vector<Economia> calcularEconomias(const Matriz& distancias) {
+    int n = distancias.size() - 1; // número de clientes (não inclui depósito)
+    vector<Economia> economias;
+    for (int i = 1; i <= n; ++i) {
+        for (int j = i + 1; j <= n; ++j) {
+            int valor = distancias[0][i] + distancias[0][j] - distancias[i][j];
+            economias.push_back(Economia(i, j, valor));
+        }
+    }
+
+    // Ordena as economias em ordem decrescente
+    sort(economias.begin(), economias.end(), compararEconomias);
+    return economias;
+}
+
+// Função para encontrar a rota de um nó
+template <typename Matriz>
+inline int encontrarRota(int node, const vector<vector<int>>& rotas, const Matriz& distancias) {
+    for (size_t i = 0; i < rotas.size(); ++i) {
+        auto it = find(rotas[i].begin(), rotas[i].end(), node);
+        if (it != rotas[i].end()) {
+            // Verificar se a rota tem custo 0
+            for (size_t j = 0; j < rotas[i].size() - 1; ++j) {
+                if (distancias[rotas[i][j]][rotas[i][j + 1]] == 0) {
+                    return -1; // Rota inválida
+                }
+            }
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Função para calcular o custo de uma rota
+template <typename Matriz>
+inline int calcularCustoRota(const vector<int>& rota, const Matriz& distancias) {
+    int custo = 0;
+    for (size_t i = 0; i < rota.size() - 1; ++i) {
+        custo += distancias[rota[i]][rota[i + 1]];
+    }
+    return custo;
+}
+
+// Função para implementar a Heurística de Clarke e Wright.
+// 'economiasPrecalculadas' permite reaproveitar a lista ordenada de economias entre resoluções da mesma matriz.
+template <typename Matriz>
+inline vector<vector<int>> clarkeWright(const Matriz& distancias, int capacidade, const vector<int>& demandas, int maxParadas, LimitesExecucao& limites,
+                                        const vector<Economia>* economiasPrecalculadas = nullptr) {
+    int n = distancias.size() - 1; // número de clientes (não inclui depósito)
+    
+    // Inicializa rotas individuais
+    vector<vector<int>> rotas;
+    for (int i = 1; i <= n; ++i) {
+        rotas.push_back({0, i, 0});
+    }
+
+    vector<Economia> calculadas;
+    if (!economiasPrecalculadas) {
+        FaseCronometrada fase("economias");
+        calculadas = calcularEconomias(distancias);
+    }
+    const vector<Economia>& economias = economiasPrecalculadas ? *economiasPrecalculadas : calculadas;
+
+    // Custo da solução inicial (uma rota por cliente); cada combinação aceita só pode reduzi-lo
+    int custoAtual = 0;
+    for (const auto& rota : rotas) {
+        custoAtual += calcularCustoRota(rota, distancias);
+    }
+    reportarMelhoria(custoAtual, limites);
+
+    // Combina rotas com base nas economias
+    {
+        FaseCronometrada fase("fusoes");
+        for (const auto& economia : economias) {
+            // ao atingir o limite as rotas atuais ja formam uma solucao valida
+            if (limites.parar()) break;
+
+            contar(ECONOMIAS_AVALIADAS);
+            int i = economia.i;
+            int j = economia.j;
+
+            int rotaI = encontrarRota(i, rotas, distancias);
+            int rotaJ = encontrarRota(j, rotas, distancias);
+
+            if (rotaI != -1 && rotaJ != -1 && rotaI != rotaJ) {
+                int demandaTotal = 0;
+                for (int cliente : rotas[rotaI]) {
+                    if (cliente != 0) {
+                        demandaTotal += demandas[cliente];
+                    }
+                }
+                for (int cliente : rotas[rotaJ]) {
+                    if (cliente != 0) {
+                        demandaTotal += demandas[cliente];
+                    }
+                }
+            
+                // Verificar se a combinação excede o número máximo de paradas
+                int numParadasRotaI = rotas[rotaI].size() - 2; // Excluindo depósito inicial e final
+                int numParadasRotaJ = rotas[rotaJ].size() - 2; // Excluindo depósito inicial e final
+                if (numParadasRotaI + numParadasRotaJ > maxParadas) {
+                    continue; // Pular essa combinação se exceder o limite de paradas
+                }
+
+                if (demandaTotal <= capacidade) {
+                    // Combina as rotas
+                    vector<int> novaRota = rotas[rotaI];
+                    novaRota.pop_back();
+                    novaRota.insert(novaRota.end(), rotas[rotaJ].begin() + 1, rotas[rotaJ].end());
+                
+                    // Verifica se a nova rota é válida
+                    bool rotaValida = true;
+                    for (size_t k = 0; k < novaRota.size() - 1; ++k) {
+                        if (distancias[novaRota[k]][novaRota[k + 1]] == 0) {
+                            rotaValida = false;
+                            break;
+                        }
+                    }
+                
+                    if (rotaValida) {
+                        int novoCusto = custoAtual - calcularCustoRota(rotas[rotaI], distancias) - calcularCustoRota(rotas[rotaJ], distancias)
+                                        + calcularCustoRota(novaRota, distancias);
+                        reportarMelhoria(novoCusto, limites);   // só imprime se for menor que o melhor já impresso
+                        custoAtual = novoCusto;
+                        rotas[rotaI] = novaRota;
+                        rotas.erase(rotas.begin() + rotaJ);
+                        contar(FUSOES_REALIZADAS);
+                    }
+                }
+            }
+        }
+    }
+
+    return rotas;
+}
+
+template <typename Matriz>
+inline int ResolverVRPClarkeWright(const Matriz& distancias, int capacidade, const vector<int>& demandas, int maxParadas, LimitesExecucao& limites,
+                                   vector<vector<int>>* rotasSaida = nullptr) {
+    vector<vector<int>> rotas = clarkeWright(distancias, capacidade, demandas, maxParadas, limites);
+    // melhor ordem das paradas dentro de cada rota (reordenacao.h)
+    if (reordenarRotas(rotas, distancias) > 0) {
+        int custoReordenado = 0;
+        for (const auto& rota : rotas) custoReordenado += calcularCustoRota(rota, distancias);
+        reportarMelhoria(custoReordenado, limites);
+    }
+
+    // Calcula e imprime o custo total
+    if (limites.esgotado) {
+        cout << "Limite de execução atingido, exibindo a melhor solução encontrada" << endl;
+    }
+    int custoTotal = 0;
+    cout << "Rotas finais:" << endl;
+    for (const auto& rota : rotas) {
+        for (int cliente : rota) {
+            cout << cliente << " ";
+        }
+        int custoRota = calcularCustoRota(rota, distancias);
+        custoTotal += custoRota;
+        cout << "(Custo: " << custoRota << ")\n";
+    }
+    cout << "Custo total: " << custoTotal << endl;
+
+    if (rotasSaida) *rotasSaida = rotas;
+    return custoTotal;
+}
+
+#endif
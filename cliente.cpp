@@ -0,0 +1,72 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// Cliente mínimo do servidor.cpp: envia um pedido (os argumentos da linha de comando) ou, sem argumentos, cada linha
+// da entrada padrão, e imprime as respostas. O tempo de ida e volta de cada pedido vai para a saída de erro.
+//   ./cliente carregar dia01 grafo.txt
+//   ./cliente resolver dia01 clarke 15 5
+//   ./cliente --socket /tmp/vrp.sock < pedidos.txt
+
+int conectar(const string& caminho) {
+    sockaddr_un endereco{};
+    endereco.sun_family = AF_UNIX;
+    strncpy(endereco.sun_path, caminho.c_str(), sizeof(endereco.sun_path) - 1);
+    int conexao = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (conexao < 0 || connect(conexao, (sockaddr*)&endereco, sizeof(endereco)) < 0) {
+        perror(("Erro ao conectar em " + caminho).c_str());
+        exit(1);
+    }
+    return conexao;
+}
+
+// Envia um pedido e lê a resposta (uma linha)
+string pedir(int conexao, const string& pedido) {
+    string mensagem = pedido + "\n";
+    if (write(conexao, mensagem.data(), mensagem.size()) != (ssize_t)mensagem.size()) {
+        return "";
+    }
+    string resposta;
+    char c;
+    while (read(conexao, &c, 1) == 1 && c != '\n') {
+        resposta += c;
+    }
+    return resposta;
+}
+
+int main(int argc, char* argv[]) {
+    string caminho = "/tmp/vrp.sock";
+    string pedido;
+    for (int i = 1; i < argc; i++) {
+        string argumento = argv[i];
+        if (argumento == "--socket" && i + 1 < argc) caminho = argv[++i];
+        else pedido += (pedido.empty() ? "" : " ") + argumento;
+    }
+
+    int conexao = conectar(caminho);
+    auto enviar = [&](const string& linha) {
+        auto inicio = steady_clock::now();
+        string resposta = pedir(conexao, linha);
+        auto fim = steady_clock::now();
+        cout << resposta << endl;
+        cerr << "[" << duration_cast<microseconds>(fim - inicio).count() / 1000.0 << " ms] " << linha << endl;
+    };
+
+    if (!pedido.empty()) {
+        enviar(pedido);
+    } else {
+        string linha;
+        while (getline(cin, linha)) {
+            if (!linha.empty()) enviar(linha);
+        }
+    }
+    close(conexao);
+    return 0;
+}
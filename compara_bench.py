@@ -0,0 +1,45 @@
+import json
+import sys
+
+def carregar(caminho):
+    """
+    Lê um JSON gerado pelo benchmark e indexa os resultados por (kernel, nos, semente).
+
+    :param caminho: Caminho do arquivo JSON.
+    :return: Dicionário (kernel, nos, semente) -> mediana em ns por operação.
+    """
+    with open(caminho) as arquivo:
+        dados = json.load(arquivo)
+    return {(r["kernel"], r["nos"], r["semente"]): r["ns_por_op"]["mediana"] for r in dados["resultados"]}
+
+
+def comparar(base, novo, limiar):
+    """
+    Compara as medianas de dois benchmarks e lista as regressões acima do limiar.
+
+    :param base: Resultados de referência (e.g. do commit anterior).
+    :param novo: Resultados a comparar.
+    :param limiar: Aumento relativo tolerado (0.10 = 10%).
+    :return: Lista de chaves que regrediram.
+    """
+    regressoes = []
+    for chave in sorted(base.keys() & novo.keys()):
+        razao = novo[chave] / base[chave] if base[chave] > 0 else 1.0
+        marca = ""
+        if razao > 1 + limiar:
+            regressoes.append(chave)
+            marca = "  <-- REGRESSAO"
+        print(f"{chave[0]:<30} n={chave[1]:<6} semente={chave[2]:<3} {base[chave]:>12.1f} -> {novo[chave]:>12.1f} ns/op  ({razao:.2f}x){marca}")
+    return regressoes
+
+############################################
+#             Exemplo de uso
+############################################
+# python compara_bench.py bench_antes.json bench_depois.json [limiar]
+if __name__ == "__main__":
+    if len(sys.argv) < 3:
+        print("uso: python compara_bench.py <base.json> <novo.json> [limiar]")
+        sys.exit(2)
+    limiar = float(sys.argv[3]) if len(sys.argv) > 3 else 0.10
+    regressoes = comparar(carregar(sys.argv[1]), carregar(sys.argv[2]), limiar)
+    sys.exit(1 if regressoes else 0)
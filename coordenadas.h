@@ -0,0 +1,232 @@
+#ifndef COORDENADAS_H
+#define COORDENADAS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "avaliacaolote.h"
+
+// Instâncias com coordenadas: em vez da lista de n x n arcos, cada nó tem uma posição e a distância é calculada
+// quando pedida, então 100 mil clientes ocupam poucos megabytes. Todos os arcos existem (distância mínima 1).
+//
+// MatrizCoordenadas tem a mesma interface de leitura de vector<vector<int>> (m[i][j] e m.size()), como as
+// matrizes de matriz.h, então os resolvedores templados na matriz rodam sobre ela sem alteração.
+// m[i][j] avulso calcula só a distância pedida; uma linha percorrida é calculada inteira de uma vez (4 distâncias
+// por instrução com AVX2) e fica num cache pequeno das linhas usadas por último.
+//
+// Formato do arquivo (texto):
+//   VRPC <numNos> <euclidiana|haversine> [escala]
+//   <no> <x> <y> <demanda>          numNos linhas; nó 0 é o depósito. Em haversine x = latitude e y = longitude, em graus
+// Distância: euclidiana * escala, ou arco do círculo máximo em km * escala (padrão 1; use 1000 para metros),
+// arredondada para o inteiro mais próximo.
+
+enum MetricaCoordenadas { METRICA_EUCLIDIANA, METRICA_HAVERSINE };
+
+const double RAIO_TERRA_KM = 6371.0;
+
+class MatrizCoordenadas {
+public:
+    // Linha i. Cada m[i][j] é calculado na hora; com o cache de linhas ligado, a linha que já está no cache é lida
+    // dele, e a que é percorrida (mais de ACESSOS_PARA_CALCULAR acessos pelo mesmo objeto, como em
+    // 'const auto& linha = m[i]') é calculada inteira de uma vez e entra no cache.
+    struct Linha {
+        static const int ACESSOS_PARA_CALCULAR = 32;
+        const MatrizCoordenadas* matriz;
+        size_t i;
+        mutable std::shared_ptr<const std::vector<int>> calculada;
+        mutable int acessos = 0;
+
+        int operator[](size_t j) const {
+            if (calculada) return (*calculada)[j];
+            if (matriz->maxLinhasCache > 0 && ++acessos > ACESSOS_PARA_CALCULAR) {
+                calculada = matriz->linhaEmCache(i);
+                return (*calculada)[j];
+            }
+            return matriz->distancia(i, j);
+        }
+    };
+
+    // Em haversine 'x' e 'y' são latitude e longitude em graus
+    MatrizCoordenadas(const std::vector<double>& x, const std::vector<double>& y, MetricaCoordenadas metrica, double escala = 1.0)
+        : metrica(metrica), escala(escala), n(x.size()) {
+        // pontos em 3 dimensões (z = 0 na euclidiana): a parte vetorizada é a mesma nas duas métricas,
+        // a corda entre os pontos; em haversine ela vira arco com 2 R asin(corda / 2)
+        px.resize(n);
+        py.resize(n);
+        pz.assign(n, 0.0);
+        for (size_t i = 0; i < n; i++) {
+            if (metrica == METRICA_HAVERSINE) {
+                double latitude = x[i] * M_PI / 180.0, longitude = y[i] * M_PI / 180.0;
+                px[i] = std::cos(latitude) * std::cos(longitude);
+                py[i] = std::cos(latitude) * std::sin(longitude);
+                pz[i] = std::sin(latitude);
+            } else {
+                px[i] = x[i];
+                py[i] = y[i];
+            }
+        }
+    }
+
+    size_t size() const { return n; }
+    size_t bytes() const { return 3 * n * sizeof(double) + cache.size() * n * sizeof(int); }
+
+    // Guarda até 'linhas' linhas percorridas (0 desliga). O cache não é seguro entre threads.
+    void usarCacheDeLinhas(int linhas) {
+        maxLinhasCache = linhas;
+        cache.clear();
+    }
+
+    int distancia(size_t i, size_t j) const {
+        if (i == j) return 0;
+        double dx = px[i] - px[j], dy = py[i] - py[j], dz = pz[i] - pz[j];
+        return arredondar(converterCorda(std::sqrt(dx * dx + dy * dy + dz * dz)));
+    }
+
+    // Ângulo (radianos, em (-pi, pi]) do nó i visto de 'centro'; em haversine, no plano tangente em 'centro'
+    double angulo(size_t i, size_t centro) const {
+        if (metrica == METRICA_EUCLIDIANA) return std::atan2(py[i] - py[centro], px[i] - px[centro]);
+        double latitude = std::asin(pz[i]), latitudeCentro = std::asin(pz[centro]);
+        double diferencaLongitude = std::atan2(py[i], px[i]) - std::atan2(py[centro], px[centro]);
+        if (diferencaLongitude > M_PI) diferencaLongitude -= 2 * M_PI;
+        if (diferencaLongitude < -M_PI) diferencaLongitude += 2 * M_PI;
+        return std::atan2(latitude - latitudeCentro, diferencaLongitude * std::cos(latitudeCentro));
+    }
+
+    // Distâncias de i para todos os nós, em 'saida' (n inteiros)
+    void calcularLinha(size_t i, int* saida) const {
+        size_t j = 0;
+#ifdef VRP_SIMD_X86
+        static const bool avx2 = nivelSimdDisponivel() >= SIMD_AVX2;
+        if (avx2) j = linhaAVX2(i, saida);
+#endif
+        for (; j < n; j++) {
+            double dx = px[i] - px[j], dy = py[i] - py[j], dz = pz[i] - pz[j];
+            saida[j] = arredondar(converterCorda(std::sqrt(dx * dx + dy * dy + dz * dz)));
+        }
+        saida[i] = 0;
+    }
+
+    Linha operator[](size_t i) const {
+        Linha linha{this, i, nullptr};
+        for (size_t k = 0; k < cache.size(); k++) {
+            if (cache[k].first == i) {
+                linha.calculada = cache[k].second;
+                break;
+            }
+        }
+        return linha;
+    }
+
+private:
+    MetricaCoordenadas metrica;
+    double escala;
+    size_t n;
+    std::vector<double> px, py, pz;
+    int maxLinhasCache = 0;
+    mutable std::vector<std::pair<size_t, std::shared_ptr<const std::vector<int>>>> cache;   // mais recente primeiro
+
+    // Linha i do cache, calculada se não estiver; a usada há mais tempo sai quando o cache está cheio
+    std::shared_ptr<const std::vector<int>> linhaEmCache(size_t i) const {
+        for (size_t k = 0; k < cache.size(); k++) {
+            if (cache[k].first == i) {
+                std::rotate(cache.begin(), cache.begin() + k, cache.begin() + k + 1);
+                return cache[0].second;
+            }
+        }
+        auto linha = std::make_shared<std::vector<int>>(n);
+        calcularLinha(i, linha->data());
+        if ((int)cache.size() >= maxLinhasCache) cache.pop_back();
+        cache.insert(cache.begin(), {i, linha});
+        return linha;
+    }
+
+    double converterCorda(double corda) const {
+        if (metrica == METRICA_HAVERSINE) return 2.0 * RAIO_TERRA_KM * std::asin(std::min(1.0, corda / 2.0)) * escala;
+        return corda * escala;
+    }
+
+    // Arredonda para o mais próximo; pontos distintos na mesma posição ficam a 1, porque 0 significa "sem arco"
+    static int arredondar(double valor) {
+        int inteiro = (int)(valor + 0.5);
+        return inteiro < 1 ? 1 : inteiro;
+    }
+
+#ifdef VRP_SIMD_X86
+    // Distâncias de i para j = 0, 4, 8, ...; retorna até onde calculou. Sem FMA, para dar o mesmo resultado do laço
+    // escalar. Em haversine só a corda é vetorizada; o asin fica no laço escalar.
+    __attribute__((target("avx2")))
+    size_t linhaAVX2(size_t i, int* saida) const {
+        const __m256d xi = _mm256_set1_pd(px[i]), yi = _mm256_set1_pd(py[i]), zi = _mm256_set1_pd(pz[i]);
+        const __m256d vescala = _mm256_set1_pd(escala), meio = _mm256_set1_pd(0.5);
+        const __m128i um = _mm_set1_epi32(1);
+        alignas(32) double cordas[4];
+        size_t j = 0;
+        for (; j + 4 <= n; j += 4) {
+            __m256d dx = _mm256_sub_pd(xi, _mm256_loadu_pd(&px[j]));
+            __m256d dy = _mm256_sub_pd(yi, _mm256_loadu_pd(&py[j]));
+            __m256d dz = _mm256_sub_pd(zi, _mm256_loadu_pd(&pz[j]));
+            __m256d soma = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+            __m256d corda = _mm256_sqrt_pd(soma);
+            if (metrica == METRICA_HAVERSINE) {
+                _mm256_store_pd(cordas, corda);
+                for (int k = 0; k < 4; k++) saida[j + k] = arredondar(converterCorda(cordas[k]));
+            } else {
+                __m128i inteiro = _mm256_cvttpd_epi32(_mm256_add_pd(_mm256_mul_pd(corda, vescala), meio));
+                _mm_storeu_si128((__m128i*)(saida + j), _mm_max_epi32(inteiro, um));
+            }
+        }
+        return j;
+    }
+#endif
+};
+
+// Verifica se o arquivo é uma instância com coordenadas (começa com "VRPC")
+inline bool arquivoCoordenadas(const std::string& nomeArquivo) {
+    std::ifstream arquivo(nomeArquivo, std::ios::binary);
+    char magica[4] = {0};
+    arquivo.read(magica, 4);
+    return arquivo.gcount() == 4 && std::memcmp(magica, "VRPC", 4) == 0;
+}
+
+// Lê a instância com coordenadas; devolve a mensagem de erro (vazia se a leitura deu certo)
+inline std::string LerInstanciaCoordenadas(const std::string& nomeArquivo, int& numVertices, std::vector<int>& demandas,
+                                           std::unique_ptr<MatrizCoordenadas>& matriz) {
+    std::ifstream arquivo(nomeArquivo);
+    if (!arquivo.is_open()) return "Erro ao abrir o arquivo " + nomeArquivo;
+
+    std::string magica, nomeMetrica, resto;
+    if (!(arquivo >> magica >> numVertices >> nomeMetrica) || magica != "VRPC" || numVertices < 1) {
+        return "Cabeçalho inválido em " + nomeArquivo;
+    }
+    MetricaCoordenadas metrica;
+    if (nomeMetrica == "euclidiana") metrica = METRICA_EUCLIDIANA;
+    else if (nomeMetrica == "haversine") metrica = METRICA_HAVERSINE;
+    else return "Métrica desconhecida em " + nomeArquivo + ": " + nomeMetrica;
+    double escala = 1.0;
+    std::getline(arquivo, resto);
+    if (!resto.empty()) escala = std::atof(resto.c_str());
+    if (escala <= 0) return "Escala inválida em " + nomeArquivo;
+
+    std::vector<double> x(numVertices), y(numVertices);
+    demandas.assign(numVertices, 0);
+    for (int k = 0; k < numVertices; k++) {
+        int no;
+        double xi, yi;
+        int demanda;
+        if (!(arquivo >> no >> xi >> yi >> demanda) || no < 0 || no >= numVertices) {
+            return "Nó inválido em " + nomeArquivo;
+        }
+        x[no] = xi;
+        y[no] = yi;
+        demandas[no] = no == 0 ? 0 : demanda;
+    }
+    matriz = std::make_unique<MatrizCoordenadas>(x, y, metrica, escala);
+    return "";
+}
+
+#endif
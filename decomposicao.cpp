@@ -0,0 +1,76 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+
+#include "decomposicao.h"
+#include "matriz.h"
+#include "limitantes.h"
+#include "arquivosolucao.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Decomposição em grupos resolvidos em paralelo (decomposicao.h), para instâncias grandes demais para uma
+// única chamada do Clarke e Wright ou da inserção mais próxima.
+//   ./decomposicao [--resolvedor clarke|greedy] [--particao varredura|kmedoides] [--clientes-por-grupo 200]
+//                  [--passadas-reparo 3] [--max-paradas 5] [--solucao arquivo]
+int main(int argc, char* argv[]) {
+    int numVertices;
+    LimitesExecucao limites;
+    LerLimites(argc, argv, limites);
+    LerInstrumentacao(argc, argv, "decomposicao");
+    ConfigDecomposicao config;
+    int capacidade = 15; // Capacidade do veículo
+    int maxParadas = 5;
+    for (int i = 1; i + 1 < argc; i++) {
+        string opcao = argv[i];
+        if (opcao == "--resolvedor") config.resolvedor = argv[++i];
+        else if (opcao == "--particao") config.particao = argv[++i];
+        else if (opcao == "--clientes-por-grupo") config.clientesPorGrupo = max(1, atoi(argv[++i]));
+        else if (opcao == "--passadas-reparo") config.passadasReparo = atoi(argv[++i]);
+        else if (opcao == "--max-paradas") maxParadas = atoi(argv[++i]);
+    }
+    if (config.resolvedor != "clarke" && config.resolvedor != "greedy") {
+        cerr << "Resolvedor desconhecido: " << config.resolvedor << " (use clarke ou greedy)" << endl;
+        return 1;
+    }
+    // como nos programas isolados: o Clarke e Wright limita as paradas por rota, a inserção mais próxima não
+    int maxClientes = config.resolvedor == "clarke" ? maxParadas - 2 : 0;
+
+    vector<int> demandas;
+    vector<vector<int>> distancias;
+    unique_ptr<MatrizCoordenadas> coordenadas;
+    {
+        FaseCronometrada fase("leitura");
+        if (arquivoCoordenadas("grafo.txt")) {
+            string erro = LerInstanciaCoordenadas("grafo.txt", numVertices, demandas, coordenadas);
+            if (!erro.empty()) {
+                cerr << erro << endl;
+                return 1;
+            }
+        } else {
+            demandas = LerDestinoDemanda("grafo.txt", numVertices);
+            distancias = LerRotasPossiveis("grafo.txt", numVertices);
+        }
+    }
+
+    vector<vector<int>> rotas;
+    auto start = high_resolution_clock::now();
+    // resolve, mede o tempo e calcula a distância até o ótimo (fora do tempo medido) sobre a mesma matriz
+    auto resolverEImprimir = [&](const auto& matriz, const MatrizCoordenadas* pontos) {
+        long long custo = ResolverVRPDecomposicao(matriz, demandas, capacidade, maxClientes, config, limites, pontos, &rotas);
+        auto end = high_resolution_clock::now();
+
+        auto duration = duration_cast<milliseconds>(end - start).count();
+        cout << "Tempo de execução: " << duration << " ms" << endl;
+        imprimirLimitante(custo, rotas, matriz, demandas, capacidade, maxClientes);
+        return custo;
+    };
+    // a densa é liberada assim que a compacta fica pronta
+    long long custo = coordenadas
+        ? resolverEImprimir(*coordenadas, coordenadas.get())
+        : comMatrizCompacta(move(distancias), [&](const auto& matriz) { return resolverEImprimir(matriz, nullptr); });
+    gravarSolucaoSePedida(argc, argv, {"decomposicao", numVertices, capacidade, maxClientes > 0 ? maxParadas : 0, custo, limites.esgotado}, rotas);
+
+    return 0;
+}
@@ -0,0 +1,422 @@
+#ifndef DECOMPOSICAO_H
+#define DECOMPOSICAO_H
+
+#include <array>
+#include <numeric>
+
+#include "clarke.h"
+#include "greedy.h"
+#include "coordenadas.h"
+
+// Decomposição "agrupa primeiro, roteia depois" para instâncias grandes.
+//
+// 1. Particiona os clientes em grupos cuja demanda total cabe num número inteiro de veículos: por varredura do
+//    ângulo em torno do depósito (instâncias com coordenadas) ou por k-medoides sobre a matriz de distâncias.
+// 2. Resolve cada grupo como uma instância independente (depósito + clientes do grupo), um grupo por thread OpenMP,
+//    com Clarke e Wright ou inserção mais próxima. Cada subinstância tem a matriz densa do grupo.
+// 3. Reparo de fronteira: entre grupos vizinhos tenta fundir rotas e mover clientes de uma rota para outra
+//    quando isso reduz o custo, respeitando capacidade, máximo de clientes por rota e arcos existentes.
+//
+// O custo das heurísticas passa de superlinear no número de clientes para linear no número de grupos; a perda
+// de qualidade fica nas fronteiras, que o reparo recupera em parte.
+
+const long long SEM_LIGACAO = 1LL << 40;    // par sem arco direto nem caminho pelo depósito
+
+struct ConfigDecomposicao {
+    string resolvedor = "clarke";           // clarke ou greedy
+    string particao = "";                   // varredura ou kmedoides; vazio: varredura se houver coordenadas
+    int clientesPorGrupo = 200;
+    int iteracoesKMedoides = 5;
+    int vizinhos = 2;                       // grupos vizinhos de cada grupo no k-medoides
+    int passadasReparo = 3;
+};
+
+struct Particao {
+    vector<vector<int>> grupos;             // clientes (índices globais) de cada grupo
+    vector<vector<int>> vizinhos;           // grupos vizinhos de cada grupo, para o reparo de fronteira
+};
+
+// Distância sem direção usada para agrupar: o arco mais barato entre i e j, ou a ida e volta pelo depósito
+template <typename Matriz>
+inline long long distanciaAgrupamento(const Matriz& distancias, int i, int j) {
+    if (i == j) return 0;
+    int ida = distancias[i][j], volta = distancias[j][i];
+    long long direta = SEM_LIGACAO;
+    if (ida != 0) direta = ida;
+    if (volta != 0 && volta < direta) direta = volta;
+    int iDeposito = distancias[0][i], jDeposito = distancias[0][j];
+    if (iDeposito != 0 && jDeposito != 0) direta = min(direta, (long long)iDeposito + jDeposito);
+    return direta;
+}
+
+// Demanda máxima de um grupo: a demanda média dos grupos arredondada para cima em veículos inteiros
+inline long long demandaMaximaGrupo(const vector<int>& demandas, int numGrupos, int capacidade) {
+    long long total = 0;
+    for (size_t i = 1; i < demandas.size(); i++) total += demandas[i];
+    long long media = (total + numGrupos - 1) / numGrupos;
+    return max<long long>(capacidade, (media + capacidade - 1) / capacidade * capacidade);
+}
+
+// Varredura: clientes em ordem de ângulo em torno do depósito, começando na maior abertura entre dois clientes
+// consecutivos, cortados sempre que o próximo passaria da demanda máxima. Vizinhos: os grupos adjacentes na varredura.
+inline Particao particionarPorVarredura(const MatrizCoordenadas& coordenadas, const vector<int>& demandas, long long demandaMaxima) {
+    Particao particao;
+    int n = coordenadas.size();
+    if (n <= 1) return particao;
+    vector<pair<double, int>> angulos;
+    for (int i = 1; i < n; i++) angulos.push_back({coordenadas.angulo(i, 0), i});
+    sort(angulos.begin(), angulos.end());
+
+    size_t comeco = 0;
+    double maiorAbertura = angulos.front().first + 2 * M_PI - angulos.back().first;
+    for (size_t k = 1; k < angulos.size(); k++) {
+        if (angulos[k].first - angulos[k - 1].first > maiorAbertura) {
+            maiorAbertura = angulos[k].first - angulos[k - 1].first;
+            comeco = k;
+        }
+    }
+
+    long long demandaGrupo = 0;
+    for (size_t k = 0; k < angulos.size(); k++) {
+        int cliente = angulos[(comeco + k) % angulos.size()].second;
+        if (particao.grupos.empty() || demandaGrupo + demandas[cliente] > demandaMaxima) {
+            particao.grupos.push_back({});
+            demandaGrupo = 0;
+        }
+        particao.grupos.back().push_back(cliente);
+        demandaGrupo += demandas[cliente];
+    }
+
+    int numGrupos = particao.grupos.size();
+    particao.vizinhos.resize(numGrupos);
+    for (int g = 0; g + 1 < numGrupos; g++) {
+        particao.vizinhos[g].push_back(g + 1);
+    }
+    if (numGrupos > 2) particao.vizinhos[numGrupos - 1].push_back(0);   // a varredura dá a volta
+    return particao;
+}
+
+// k-medoides com atribuição limitada pela demanda máxima. Medoides iniciais pelo mais distante dos já escolhidos;
+// em cada iteração os clientes são atribuídos ao medoide mais próximo com espaço (primeiro os que mais perdem
+// se ficarem sem o preferido) e cada grupo troca o medoide pelo membro de menor soma de distâncias aos demais.
+template <typename Matriz>
+inline Particao particionarKMedoides(const Matriz& distancias, const vector<int>& demandas, int numGrupos,
+                                     long long demandaMaxima, int iteracoes, int numVizinhos) {
+    Particao particao;
+    int n = distancias.size();
+    int clientes = n - 1;
+    numGrupos = max(1, min(numGrupos, clientes));
+    if (clientes <= 0) return particao;
+
+    // medoides iniciais: o cliente mais distante do depósito e depois o mais distante dos medoides já escolhidos
+    vector<int> medoides;
+    vector<long long> maisProximo(n, SEM_LIGACAO + 1);
+    int proximo = 1;
+    for (int i = 1; i < n; i++) {
+        if (distanciaAgrupamento(distancias, 0, i) > distanciaAgrupamento(distancias, 0, proximo)) proximo = i;
+    }
+    while ((int)medoides.size() < numGrupos) {
+        medoides.push_back(proximo);
+        #pragma omp parallel for schedule(static)
+        for (int i = 1; i < n; i++) {
+            maisProximo[i] = min(maisProximo[i], distanciaAgrupamento(distancias, i, proximo));
+        }
+        proximo = 1;
+        for (int i = 1; i < n; i++) {
+            if (maisProximo[i] > maisProximo[proximo]) proximo = i;
+        }
+    }
+
+    const int CANDIDATOS = 4;
+    vector<int> grupoDoCliente(n, -1);
+    for (int iteracao = 0; iteracao < iteracoes; iteracao++) {
+        // medoides mais próximos de cada cliente e o quanto ele perde indo para o segundo
+        vector<array<int, CANDIDATOS>> candidatos(n);
+        vector<long long> arrependimento(n, 0);
+        #pragma omp parallel for schedule(static)
+        for (int i = 1; i < n; i++) {
+            vector<pair<long long, int>> ordem;
+            for (int g = 0; g < numGrupos; g++) ordem.push_back({distanciaAgrupamento(distancias, i, medoides[g]), g});
+            int k = min<int>(CANDIDATOS, numGrupos);
+            partial_sort(ordem.begin(), ordem.begin() + k, ordem.end());
+            candidatos[i].fill(-1);
+            for (int c = 0; c < k; c++) candidatos[i][c] = ordem[c].second;
+            arrependimento[i] = k > 1 ? ordem[1].first - ordem[0].first : 0;
+        }
+        vector<int> ordemClientes;
+        for (int i = 1; i < n; i++) ordemClientes.push_back(i);
+        stable_sort(ordemClientes.begin(), ordemClientes.end(), [&](int a, int b) { return arrependimento[a] > arrependimento[b]; });
+
+        vector<long long> demandaGrupo(numGrupos, 0);
+        for (int i : ordemClientes) {
+            int escolhido = -1;
+            for (int g : candidatos[i]) {
+                if (g >= 0 && demandaGrupo[g] + demandas[i] <= demandaMaxima) {
+                    escolhido = g;
+                    break;
+                }
+            }
+            if (escolhido < 0) {
+                // todos os preferidos cheios: o medoide mais próximo com espaço, ou o mais próximo de todos
+                long long melhor = LLONG_MAX;
+                for (int g = 0; g < numGrupos; g++) {
+                    long long d = distanciaAgrupamento(distancias, i, medoides[g]);
+                    if (demandaGrupo[g] + demandas[i] <= demandaMaxima && d < melhor) {
+                        melhor = d;
+                        escolhido = g;
+                    }
+                }
+                if (escolhido < 0) escolhido = candidatos[i][0];
+            }
+            grupoDoCliente[i] = escolhido;
+            demandaGrupo[escolhido] += demandas[i];
+        }
+
+        particao.grupos.assign(numGrupos, {});
+        for (int i = 1; i < n; i++) particao.grupos[grupoDoCliente[i]].push_back(i);
+
+        bool mudou = false;
+        #pragma omp parallel for schedule(dynamic) reduction(||:mudou)
+        for (int g = 0; g < numGrupos; g++) {
+            const vector<int>& membros = particao.grupos[g];
+            long long melhorSoma = LLONG_MAX;
+            int melhorMedoide = medoides[g];
+            for (int a : membros) {
+                long long soma = 0;
+                for (int b : membros) soma += distanciaAgrupamento(distancias, a, b);
+                if (soma < melhorSoma) {
+                    melhorSoma = soma;
+                    melhorMedoide = a;
+                }
+            }
+            if (melhorMedoide != medoides[g]) mudou = true;
+            medoides[g] = melhorMedoide;
+        }
+        if (!mudou) break;
+    }
+
+    // grupos vazios (mais grupos que lugares para os clientes) saem da partição
+    vector<int> medoidesUsados;
+    vector<vector<int>> grupos;
+    for (int g = 0; g < numGrupos; g++) {
+        if (particao.grupos[g].empty()) continue;
+        grupos.push_back(particao.grupos[g]);
+        medoidesUsados.push_back(medoides[g]);
+    }
+    particao.grupos = grupos;
+
+    // vizinhos: os grupos de medoide mais próximo
+    int usados = medoidesUsados.size();
+    particao.vizinhos.assign(usados, {});
+    for (int g = 0; g < usados; g++) {
+        vector<pair<long long, int>> ordem;
+        for (int h = 0; h < usados; h++) {
+            if (h != g) ordem.push_back({distanciaAgrupamento(distancias, medoidesUsados[g], medoidesUsados[h]), h});
+        }
+        int k = min<int>(numVizinhos, ordem.size());
+        partial_sort(ordem.begin(), ordem.begin() + k, ordem.end());
+        for (int c = 0; c < k; c++) {
+            int h = ordem[c].second;
+            if (h > g || find(particao.vizinhos[h].begin(), particao.vizinhos[h].end(), g) == particao.vizinhos[h].end()) {
+                particao.vizinhos[g].push_back(h);
+            }
+        }
+    }
+    return particao;
+}
+
+// Resolve cada grupo como subinstância (nó 0 = depósito, nó k = k-ésimo cliente do grupo) e devolve as rotas
+// de cada grupo em índices globais. Os grupos maiores começam primeiro para equilibrar as threads.
+template <typename Matriz>
+inline vector<vector<vector<int>>> resolverGrupos(const Matriz& distancias, const vector<int>& demandas, int capacidade, int maxClientes,
+                                                  const Particao& particao, const ConfigDecomposicao& config, LimitesExecucao& limites) {
+    int numGrupos = particao.grupos.size();
+    vector<vector<vector<int>>> rotasPorGrupo(numGrupos);
+    vector<int> ordem(numGrupos);
+    iota(ordem.begin(), ordem.end(), 0);
+    sort(ordem.begin(), ordem.end(), [&](int a, int b) { return particao.grupos[a].size() > particao.grupos[b].size(); });
+
+    FaseCronometrada fase("grupos");
+    #pragma omp parallel for schedule(dynamic)
+    for (int k = 0; k < numGrupos; k++) {
+        int g = ordem[k];
+        vector<int> nos = {0};
+        nos.insert(nos.end(), particao.grupos[g].begin(), particao.grupos[g].end());
+        int m = nos.size();
+        // acessos avulsos a distancias: a matriz de coordenadas não mexe no cache de linhas, então é segura entre threads
+        vector<vector<int>> sub(m, vector<int>(m));
+        vector<int> demandasSub(m);
+        for (int a = 0; a < m; a++) {
+            demandasSub[a] = a == 0 ? 0 : demandas[nos[a]];
+            for (int b = 0; b < m; b++) sub[a][b] = distancias[nos[a]][nos[b]];
+        }
+        vector<vector<int>> rotas = config.resolvedor == "greedy"
+            ? insercaoMaisProxima(sub, demandasSub, capacidade, limites)
+            : clarkeWright(sub, capacidade, demandasSub, maxClientes, limites);
+        for (auto& rota : rotas) {
+            for (int& no : rota) no = nos[no];
+        }
+        rotasPorGrupo[g] = rotas;
+        contar(GRUPOS_RESOLVIDOS);
+    }
+    return rotasPorGrupo;
+}
+
+// Melhor movimento entre uma rota de cada grupo: fundir as duas (em qualquer ordem) ou mover um cliente da
+// primeira para a segunda. Aplica o movimento se ele reduz o custo e retorna a redução (0 se nenhum).
+template <typename Matriz>
+inline long long melhorarPar(vector<int>& origem, vector<int>& destino, const Matriz& distancias, const vector<int>& demandas,
+                             int capacidade, int maxClientes) {
+    long long custoOrigem = calcularCusto<long long>(origem, distancias), custoDestino = calcularCusto<long long>(destino, distancias);
+    if (custoOrigem < 0 || custoDestino < 0) return 0;
+    int cargaOrigem = cargaRota(origem, demandas), cargaDestino = cargaRota(destino, demandas);
+    int clientesOrigem = origem.size() - 2, clientesDestino = destino.size() - 2;
+
+    // fusão: origem seguida do destino ou o contrário, numa rota só
+    if (cargaOrigem + cargaDestino <= capacidade && (maxClientes <= 0 || clientesOrigem + clientesDestino <= maxClientes)) {
+        for (int sentido = 0; sentido < 2; sentido++) {
+            const vector<int>& primeira = sentido == 0 ? origem : destino;
+            const vector<int>& segunda = sentido == 0 ? destino : origem;
+            vector<int> fundida(primeira.begin(), primeira.end() - 1);
+            fundida.insert(fundida.end(), segunda.begin() + 1, segunda.end());
+            long long custo = calcularCusto<long long>(fundida, distancias);
+            if (custo >= 0 && custo < custoOrigem + custoDestino) {
+                destino = fundida;
+                origem = {0, 0};
+                contar(FUSOES_REALIZADAS);
+                return custoOrigem + custoDestino - custo;
+            }
+        }
+    }
+
+    // realocação: o cliente da origem cuja ida para a melhor posição do destino mais economiza
+    if (maxClientes > 0 && clientesDestino + 1 > maxClientes) return 0;
+    long long melhorGanho = 0;
+    int melhorPosicaoOrigem = -1, melhorPosicaoDestino = -1;
+    for (int a = 1; a + 1 < (int)origem.size(); a++) {
+        int cliente = origem[a];
+        if (cargaDestino + demandas[cliente] > capacidade) continue;
+        int antes = origem[a - 1], depois = origem[a + 1];
+        long long retirada = (long long)distancias[antes][cliente] + distancias[cliente][depois];
+        long long atalho = distancias[antes][depois];
+        if (atalho == 0 && !(antes == 0 && depois == 0)) continue;   // a origem deixaria de ser válida
+        for (int b = 0; b + 1 < (int)destino.size(); b++) {
+            int x = destino[b], y = destino[b + 1];
+            int entrada = distancias[x][cliente], saida = distancias[cliente][y];
+            if (entrada == 0 || saida == 0) continue;
+            long long ganho = retirada - atalho - ((long long)entrada + saida - distancias[x][y]);
+            if (ganho > melhorGanho) {
+                melhorGanho = ganho;
+                melhorPosicaoOrigem = a;
+                melhorPosicaoDestino = b + 1;
+            }
+        }
+    }
+    if (melhorPosicaoOrigem < 0) return 0;
+    int cliente = origem[melhorPosicaoOrigem];
+    origem.erase(origem.begin() + melhorPosicaoOrigem);
+    destino.insert(destino.begin() + melhorPosicaoDestino, cliente);
+    if (origem.size() == 2) origem = {0, 0};   // rota esvaziada: o custo do depósito ao depósito é descontado no ganho
+    contar(REALOCACOES_FRONTEIRA);
+    return melhorGanho;
+}
+
+// Reparo de fronteira entre cada par de grupos vizinhos, nas duas direções, até não haver melhoria ou
+// acabarem as passadas. Rotas esvaziadas ({0, 0}) são removidas no fim. Retorna a redução total de custo.
+template <typename Matriz>
+inline long long repararFronteiras(const Matriz& distancias, const vector<int>& demandas, int capacidade, int maxClientes,
+                                   const Particao& particao, vector<vector<vector<int>>>& rotasPorGrupo,
+                                   int passadas, LimitesExecucao& limites) {
+    FaseCronometrada fase("reparo_fronteira");
+    long long reducao = 0;
+    for (int passada = 0; passada < passadas; passada++) {
+        long long reducaoPassada = 0;
+        for (size_t g = 0; g < particao.vizinhos.size() && !limites.tempoEsgotado(); g++) {
+            for (int h : particao.vizinhos[g]) {
+                for (int sentido = 0; sentido < 2; sentido++) {
+                    auto& rotasOrigem = rotasPorGrupo[sentido == 0 ? g : h];
+                    auto& rotasDestino = rotasPorGrupo[sentido == 0 ? h : g];
+                    for (auto& origem : rotasOrigem) {
+                        for (auto& destino : rotasDestino) {
+                            if (origem.size() <= 2 || destino.size() <= 2) continue;
+                            reducaoPassada += melhorarPar(origem, destino, distancias, demandas, capacidade, maxClientes);
+                        }
+                    }
+                }
+            }
+        }
+        reducao += reducaoPassada;
+        if (reducaoPassada == 0) break;
+    }
+    for (auto& rotas : rotasPorGrupo) {
+        rotas.erase(remove_if(rotas.begin(), rotas.end(), [](const vector<int>& rota) { return rota.size() <= 2; }), rotas.end());
+    }
+    return reducao;
+}
+
+// Decomposição completa. 'coordenadas' (opcional) permite a partição por varredura; sem ela usa k-medoides.
+// Imprime as rotas e o custo no formato dos outros resolvedores.
+template <typename Matriz>
+inline long long ResolverVRPDecomposicao(const Matriz& distancias, const vector<int>& demandas, int capacidade, int maxClientes,
+                                         const ConfigDecomposicao& config, LimitesExecucao& limites,
+                                         const MatrizCoordenadas* coordenadas = nullptr, vector<vector<int>>* rotasSaida = nullptr) {
+    int clientes = distancias.size() - 1;
+    int numGrupos = max(1, (clientes + config.clientesPorGrupo - 1) / config.clientesPorGrupo);
+    long long demandaMaxima = demandaMaximaGrupo(demandas, numGrupos, capacidade);
+
+    string particaoUsada = config.particao;
+    if (particaoUsada.empty()) particaoUsada = coordenadas ? "varredura" : "kmedoides";
+    if (particaoUsada == "varredura" && !coordenadas) {
+        cerr << "A partição por varredura precisa de uma instância com coordenadas; usando k-medoides" << endl;
+        particaoUsada = "kmedoides";
+    }
+    Particao particao;
+    {
+        FaseCronometrada fase("particao");
+        particao = particaoUsada == "varredura"
+            ? particionarPorVarredura(*coordenadas, demandas, demandaMaxima)
+            : particionarKMedoides(distancias, demandas, numGrupos, demandaMaxima, config.iteracoesKMedoides, config.vizinhos);
+    }
+
+    // os custos parciais de cada grupo não são soluções da instância: nada é reportado até o fim
+    bool reportar = limites.reportar;
+    limites.reportar = false;
+    auto rotasPorGrupo = resolverGrupos(distancias, demandas, capacidade, maxClientes, particao, config, limites);
+    limites.reportar = reportar;
+
+    long long custoGrupos = 0;
+    for (const auto& rotas : rotasPorGrupo) {
+        for (const auto& rota : rotas) custoGrupos += calcularCusto<long long>(rota, distancias);
+    }
+    long long reducao = repararFronteiras(distancias, demandas, capacidade, maxClientes, particao, rotasPorGrupo,
+                                          config.passadasReparo, limites);
+
+    vector<vector<int>> rotas;
+    for (auto& grupo : rotasPorGrupo) {
+        for (auto& rota : grupo) rotas.push_back(move(rota));
+    }
+    long long reducaoReordenacao = reordenarRotas(rotas, distancias);
+    long long custoTotal = 0;
+    for (const auto& rota : rotas) custoTotal += calcularCusto<long long>(rota, distancias);
+    reportarMelhoria(custoTotal, limites);
+
+    if (limites.esgotado) {
+        cout << "Limite de execução atingido, exibindo a melhor solução encontrada" << endl;
+    }
+    cout << "Decomposição: " << particao.grupos.size() << " grupos (" << particaoUsada << ", " << config.resolvedor
+         << "), custo " << custoGrupos << " antes do reparo de fronteira, " << custoGrupos - reducao << " depois e "
+         << custoGrupos - reducao - reducaoReordenacao << " com a reordenação das rotas" << endl;
+    cout << "Rotas finais:" << endl;
+    for (const auto& rota : rotas) {
+        for (int cliente : rota) {
+            cout << cliente << " ";
+        }
+        cout << "(Custo: " << calcularCusto<long long>(rota, distancias) << ")\n";
+    }
+    cout << "Custo total: " << custoTotal << endl;
+
+    if (rotasSaida) *rotasSaida = rotas;
+    return custoTotal;
+}
+
+#endif
@@ -0,0 +1,247 @@
+import argparse
+import json
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+
+
+def lista_inteiros(texto):
+    """
+    Converte uma lista separada por vírgulas (e.g. "1,2,4") em inteiros.
+
+    :param texto: Lista na linha de comando.
+    :return: Lista de inteiros.
+    """
+    return [int(valor) for valor in texto.split(",") if valor]
+
+
+def gerar_instancia(bin_dir, dir_trabalho, nos, semente):
+    """
+    Gera (uma vez) a instância com o geraGrafo, num diretório próprio, como grafo.txt.
+
+    :param bin_dir: Diretório dos executáveis.
+    :param dir_trabalho: Diretório onde ficam as instâncias e os relatórios.
+    :param nos: Número de nós, incluindo o depósito.
+    :param semente: Semente do gerador.
+    :return: Diretório da instância (os programas leem grafo.txt do diretório atual).
+    """
+    diretorio = os.path.join(dir_trabalho, f"n{nos}_s{semente}")
+    os.makedirs(diretorio, exist_ok=True)
+    grafo = os.path.join(diretorio, "grafo.txt")
+    if not os.path.exists(grafo):
+        subprocess.run([os.path.join(bin_dir, "geraGrafo"), str(nos), "--semente", str(semente), "--saida", grafo],
+                       check=True, stdout=subprocess.DEVNULL)
+    return diretorio
+
+
+def ler_estatisticas(diretorio, prefixo, ranks):
+    """
+    Lê os relatórios de --estatisticas de uma execução. No MPI com mais de um rank há um arquivo por rank.
+
+    :param diretorio: Diretório da execução.
+    :param prefixo: Nome do arquivo passado em --estatisticas, sem a extensão .json.
+    :param ranks: Número de ranks (1 para o openmp).
+    :return: (tempo em ms do rank mais lento, trabalho da instância).
+    """
+    arquivos = [f"{prefixo}.json"] if ranks == 1 else [f"{prefixo}.rank{r}.json" for r in range(ranks)]
+    tempo, enumeracao, custo = 0, 0, 0
+    for nome in arquivos:
+        with open(os.path.join(diretorio, nome)) as arquivo:
+            dados = json.load(arquivo)
+        total = lambda contador: dados["contadores"].get(contador, {}).get("total", 0)
+        tempo = max(tempo, dados["tempo_total_ms"])
+        # no MPI cada rank repete a geração e a enumeração e divide o custo dos itinerários
+        enumeracao = max(enumeracao, total("permutacoes_visitadas") + total("combinacoes_visitadas"))
+        custo += total("itinerarios_avaliados")
+        os.remove(os.path.join(diretorio, nome))
+    return tempo, enumeracao + custo
+
+
+def executar(args, programa, diretorio, ranks, threads):
+    """
+    Executa um programa na instância do diretório, --repeticoes vezes, e resume as medições pela mediana.
+
+    :param args: Opções da linha de comando.
+    :param programa: "openmp" ou "MPI".
+    :param diretorio: Diretório da instância.
+    :param ranks: Número de ranks MPI (1 para o openmp).
+    :param threads: OMP_NUM_THREADS de cada processo.
+    :return: Dicionário com tempo (ms), trabalho e custo encontrado.
+    """
+    ambiente = dict(os.environ, OMP_NUM_THREADS=str(threads))
+    executavel = os.path.join(args.bin_dir, programa)
+    comando = [executavel, "--estatisticas", "estat.json"]
+    if programa == "MPI":
+        comando = args.mpirun.split() + [args.opcao_ranks, str(ranks)] + comando
+    tempos, trabalhos, custos = [], [], set()
+    for _ in range(args.repeticoes):
+        saida = subprocess.run(comando, cwd=diretorio, env=ambiente, capture_output=True, text=True, timeout=args.timeout, check=True)
+        custo = re.search(r"Menor custo: (-?\d+)", saida.stdout)
+        custos.add(int(custo.group(1)) if custo else None)
+        tempo, trabalho = ler_estatisticas(diretorio, "estat", ranks)
+        tempos.append(tempo)
+        trabalhos.append(trabalho)
+    return {"tempo_ms": statistics.median(tempos), "tempos_ms": tempos, "trabalho": max(trabalhos), "custos": sorted(c for c in custos if c is not None)}
+
+
+def metricas(t1, tp, p, trabalho1=0, trabalhop=0):
+    """
+    Speedup, eficiência e a fração serial de Karp-Flatt. No escalonamento fraco, o speedup é corrigido pela razão
+    entre o trabalho feito com p unidades e p vezes o trabalho da referência (quando os contadores existem), já que
+    o trabalho da busca global não cresce linearmente com o tamanho da instância.
+
+    :param t1: Tempo da referência (uma unidade de processamento).
+    :param tp: Tempo com p unidades.
+    :param p: Unidades de processamento (ranks x threads).
+    :param trabalho1: Trabalho da instância da referência (0 no escalonamento forte).
+    :param trabalhop: Trabalho da instância medida com p unidades.
+    :return: (speedup, eficiência, Karp-Flatt ou None para p = 1).
+    """
+    speedup = t1 / tp if tp > 0 else float("inf")
+    if trabalho1 > 0 and trabalhop > 0:
+        speedup *= trabalhop / trabalho1
+    eficiencia = speedup / p
+    karp_flatt = (1 / speedup - 1 / p) / (1 - 1 / p) if p > 1 and speedup > 0 else None
+    return speedup, eficiencia, karp_flatt
+
+
+def configuracoes(args, programa):
+    """
+    Combinações de (ranks, threads) de um programa; a primeira é sempre a referência com uma unidade.
+
+    :param args: Opções da linha de comando.
+    :param programa: "openmp" ou "MPI".
+    :return: Lista de (ranks, threads) em ordem crescente de unidades.
+    """
+    if programa == "openmp":
+        combinacoes = {(1, t) for t in args.threads}
+    else:
+        combinacoes = {(r, t) for r in args.ranks for t in args.threads_por_rank}
+    combinacoes.add((1, 1))
+    return sorted(combinacoes, key=lambda c: (c[0] * c[1], c))
+
+
+def escalonamento_forte(args, programa, linhas):
+    """
+    Escalonamento forte: cada instância de --nos com todas as configurações; a referência é a de uma unidade.
+    """
+    for nos in args.nos:
+        for semente in args.sementes:
+            diretorio = gerar_instancia(args.bin_dir, args.dir_trabalho, nos, semente)
+            referencia = None
+            for ranks, threads in configuracoes(args, programa):
+                p = ranks * threads
+                medida = executar(args, programa, diretorio, ranks, threads)
+                referencia = referencia or medida
+                speedup, eficiencia, karp_flatt = metricas(referencia["tempo_ms"], medida["tempo_ms"], p)
+                linhas.append({"programa": programa, "modo": "forte", "nos": nos, "semente": semente, "ranks": ranks, "threads": threads,
+                               "p": p, **medida, "speedup": speedup, "eficiencia": eficiencia, "karp_flatt": karp_flatt})
+                imprimir_linha(linhas[-1])
+
+
+def escalonamento_fraco(args, programa, linhas):
+    """
+    Escalonamento fraco: a i-ésima configuração (em ordem de unidades) roda na instância de --nos-fraco[i].
+    """
+    combinacoes = configuracoes(args, programa)
+    if len(args.nos_fraco) < len(combinacoes):
+        print(f"{programa}: --nos-fraco precisa de {len(combinacoes)} tamanhos, um por configuração {combinacoes}", file=sys.stderr)
+        sys.exit(2)
+    for semente in args.sementes:
+        referencia = None
+        for (ranks, threads), nos in zip(combinacoes, args.nos_fraco):
+            p = ranks * threads
+            diretorio = gerar_instancia(args.bin_dir, args.dir_trabalho, nos, semente)
+            medida = executar(args, programa, diretorio, ranks, threads)
+            referencia = referencia or medida
+            speedup, eficiencia, karp_flatt = metricas(referencia["tempo_ms"], medida["tempo_ms"], p, referencia["trabalho"], medida["trabalho"])
+            linhas.append({"programa": programa, "modo": "fraco", "nos": nos, "semente": semente, "ranks": ranks, "threads": threads,
+                           "p": p, **medida, "speedup": speedup, "eficiencia": eficiencia, "karp_flatt": karp_flatt})
+            imprimir_linha(linhas[-1])
+
+
+def imprimir_cabecalho():
+    print(f"{'programa':<8} {'modo':<6} {'nos':>4} {'semente':>7} {'ranks':>5} {'threads':>7} {'p':>4} {'tempo ms':>10} "
+          f"{'speedup':>8} {'efic.':>6} {'karp-flatt':>10} {'trabalho/p':>12}  custo")
+
+
+def imprimir_linha(linha):
+    karp_flatt = f"{linha['karp_flatt']:.4f}" if linha["karp_flatt"] is not None else "-"
+    custos = ",".join(str(c) for c in linha["custos"])
+    aviso = "  <-- CUSTOS DIFERENTES" if len(linha["custos"]) > 1 else ""
+    print(f"{linha['programa']:<8} {linha['modo']:<6} {linha['nos']:>4} {linha['semente']:>7} {linha['ranks']:>5} {linha['threads']:>7} "
+          f"{linha['p']:>4} {linha['tempo_ms']:>10.1f} {linha['speedup']:>8.2f} {linha['eficiencia']:>6.2f} {karp_flatt:>10} "
+          f"{linha['trabalho'] // linha['p']:>12}  {custos}{aviso}", flush=True)
+
+
+def comparar(base, novo, limiar):
+    """
+    Compara a eficiência de duas execuções do driver e lista as configurações que perderam mais que o limiar.
+
+    :param base: Linhas de referência (e.g. do commit anterior).
+    :param novo: Linhas a comparar.
+    :param limiar: Queda tolerada na eficiência, em pontos (0.10 = 10 pontos percentuais).
+    :return: Lista de chaves que regrediram.
+    """
+    chave = lambda l: (l["programa"], l["modo"], l["nos"], l["semente"], l["ranks"], l["threads"])
+    base = {chave(l): l["eficiencia"] for l in base}
+    novo = {chave(l): l["eficiencia"] for l in novo}
+    regressoes = []
+    for k in sorted(base.keys() & novo.keys()):
+        marca = ""
+        if base[k] - novo[k] > limiar:
+            regressoes.append(k)
+            marca = "  <-- REGRESSAO"
+        print(f"{k[0]:<8} {k[1]:<6} n={k[2]:<4} semente={k[3]:<3} ranks={k[4]:<3} threads={k[5]:<3} eficiência {base[k]:.2f} -> {novo[k]:.2f}{marca}")
+    return regressoes
+
+
+############################################
+#             Exemplo de uso
+############################################
+# python escalabilidade.py --threads 1,2,4,8 --ranks 1,2,4 --nos 9,10 --saida escalabilidade.json
+# python escalabilidade.py --modo fraco --threads 1,2,4 --nos-fraco 9,10,11 --programas openmp
+# python escalabilidade.py ... --comparar escalabilidade_antes.json --limiar 0.10
+if __name__ == "__main__":
+    diretorio_script = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description="Escalonamento forte e fraco do openmp e do MPI: speedup, eficiência e Karp-Flatt.")
+    parser.add_argument("--programas", default="openmp,MPI", help="programas medidos, separados por vírgula")
+    parser.add_argument("--modo", choices=["forte", "fraco", "ambos"], default="forte")
+    parser.add_argument("--threads", type=lista_inteiros, default=[1, 2, 4], help="threads do openmp")
+    parser.add_argument("--ranks", type=lista_inteiros, default=[1, 2, 4], help="ranks do MPI")
+    parser.add_argument("--threads-por-rank", type=lista_inteiros, default=[1], help="OMP_NUM_THREADS de cada rank do MPI")
+    parser.add_argument("--nos", type=lista_inteiros, default=[9, 10], help="tamanhos das instâncias do escalonamento forte")
+    parser.add_argument("--nos-fraco", type=lista_inteiros, default=[9, 10, 11], help="tamanho da instância de cada configuração no escalonamento fraco")
+    parser.add_argument("--sementes", type=lista_inteiros, default=[1])
+    parser.add_argument("--repeticoes", type=int, default=3, help="execuções por medida (vale a mediana)")
+    parser.add_argument("--mpirun", default="mpirun --oversubscribe", help="lançador do MPI (e.g. \"srun\" no Slurm)")
+    parser.add_argument("--opcao-ranks", default="-n", help="opção do lançador para o número de processos (-n vale no mpirun e no srun)")
+    parser.add_argument("--bin-dir", default=diretorio_script, help="diretório do openmp, MPI e geraGrafo compilados")
+    parser.add_argument("--dir-trabalho", default=None, help="diretório das instâncias geradas (padrão: temporário)")
+    parser.add_argument("--timeout", type=float, default=None, help="tempo máximo de cada execução, em segundos")
+    parser.add_argument("--saida", default="escalabilidade.json")
+    parser.add_argument("--comparar", default=None, help="resultado anterior do driver, para apontar regressões de eficiência")
+    parser.add_argument("--limiar", type=float, default=0.10)
+    args = parser.parse_args()
+    args.bin_dir = os.path.abspath(args.bin_dir)
+    args.dir_trabalho = os.path.abspath(args.dir_trabalho or tempfile.mkdtemp(prefix="escalabilidade_"))
+
+    linhas = []
+    imprimir_cabecalho()
+    for programa in args.programas.split(","):
+        if args.modo in ("forte", "ambos"):
+            escalonamento_forte(args, programa, linhas)
+        if args.modo in ("fraco", "ambos"):
+            escalonamento_fraco(args, programa, linhas)
+
+    with open(args.saida, "w") as arquivo:
+        json.dump({"instancias": args.dir_trabalho, "repeticoes": args.repeticoes, "resultados": linhas}, arquivo, indent=2)
+    print(f"Resultados gravados em {args.saida}")
+
+    if args.comparar:
+        with open(args.comparar) as arquivo:
+            regressoes = comparar(json.load(arquivo)["resultados"], linhas, args.limiar)
+        sys.exit(1 if regressoes else 0)
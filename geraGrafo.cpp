@@ -0,0 +1,196 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <charconv>
+#include <chrono>
+#include <omp.h>
+
+#include "gerador.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Gerador de instâncias em C++, equivalente ao geraGrafo.py mas com semente, paralelo e com memória limitada:
+// o grafo é gerado em blocos de linhas que são gravados no arquivo assim que ficam prontos, sem montar o dicionário de arcos.
+//
+// Formato texto: o mesmo do geraGrafo.py (lido por LerDestinoDemanda/LerRotasPossiveis).
+// Formato binário (--binario), também aceito pelas funções de leitura:
+//   "VRPB" | int32 versao | int32 numNos | int32 demandas[numNos-1] (nós 1..numNos-1) | int64 numArcos | numArcos x (int32 origem, destino, custo)
+
+// Instância com coordenadas (--coordenadas, formato de coordenadas.h): um ponto por nó, O(n) no arquivo
+int gravarCoordenadas(const ParametrosGerador& p, const string& saida) {
+    FILE* arquivo = fopen(saida.c_str(), "wb");
+    if (!arquivo) {
+        cerr << "Erro ao abrir o arquivo " << saida << endl;
+        return 1;
+    }
+    fprintf(arquivo, "VRPC %d euclidiana\n", p.numNos);
+    for (int i = 0; i < p.numNos; i++) {
+        fprintf(arquivo, "%d %.3f %.3f %d\n", i, coordenadaDoNo(p, i, 0), coordenadaDoNo(p, i, 1), i == 0 ? 0 : demandaDoNo(p, i));
+    }
+    fclose(arquivo);
+    return 0;
+}
+
+struct Bloco {
+    int linhaInicio, linhaFim;      // linhas [inicio, fim) da parte de clientes (arcos i -> j, i < j)
+};
+
+// Divide as linhas em blocos com aproximadamente 'paresPorBloco' pares (i, j) cada
+vector<Bloco> dividirEmBlocos(int numNos, long long paresPorBloco) {
+    vector<Bloco> blocos;
+    int inicio = 1;
+    long long pares = 0;
+    for (int i = 1; i < numNos; i++) {
+        pares += numNos - i - 1;
+        if (pares >= paresPorBloco || i == numNos - 1) {
+            blocos.push_back({inicio, i + 1});
+            inicio = i + 1;
+            pares = 0;
+        }
+    }
+    return blocos;
+}
+
+void escreverTexto(string& buffer, int a, int b, int c) {
+    char tmp[48];
+    char* fim = tmp + 12;   // cada inteiro de 32 bits ocupa no máximo 11 caracteres
+    char* p = to_chars(tmp, fim, a).ptr; *p++ = ' ';
+    fim = p + 12;
+    p = to_chars(p, fim, b).ptr; *p++ = ' ';
+    fim = p + 12;
+    p = to_chars(p, fim, c).ptr; *p++ = '\n';
+    buffer.append(tmp, p - tmp);
+}
+
+void escreverBinario(string& buffer, int a, int b, int c) {
+    int32_t trio[3] = {a, b, c};
+    buffer.append(reinterpret_cast<const char*>(trio), sizeof(trio));
+}
+
+// Gera os arcos de clientes de um bloco no formato pedido
+void gerarBloco(const ParametrosGerador& p, const Bloco& bloco, bool binario, string& buffer) {
+    buffer.clear();
+    for (int i = bloco.linhaInicio; i < bloco.linhaFim; i++) {
+        for (int j = i + 1; j < p.numNos; j++) {
+            int peso = pesoDoArco(p, i, j);
+            if (peso == 0) continue;
+            if (binario) escreverBinario(buffer, i, j, peso);
+            else escreverTexto(buffer, i, j, peso);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    ParametrosGerador p;
+    string saida = "grafo.txt";
+    bool binario = false;
+    bool coordenadas = false;
+
+    for (int i = 1; i < argc; i++) {
+        string opcao = argv[i];
+        if (opcao == "--binario") binario = true;
+        else if (opcao == "--coordenadas") coordenadas = true;
+        else if (opcao == "--semente" && i + 1 < argc) p.semente = strtoull(argv[++i], nullptr, 10);
+        else if (opcao == "--max-peso" && i + 1 < argc) p.maxPeso = atoi(argv[++i]);
+        else if (opcao == "--probabilidade" && i + 1 < argc) p.probabilidade = atof(argv[++i]);
+        else if (opcao == "--saida" && i + 1 < argc) saida = argv[++i];
+        else p.numNos = atoi(argv[i]);
+    }
+    if (p.numNos < 2 || p.maxPeso < 1) {
+        cerr << "uso: ./geraGrafo <num_nos> [--semente s] [--max-peso 100] [--probabilidade 0.25] [--saida grafo.txt] [--binario | --coordenadas]" << endl;
+        return 1;
+    }
+
+    auto inicio = high_resolution_clock::now();
+
+    if (coordenadas) {
+        if (gravarCoordenadas(p, saida) != 0) return 1;
+        auto fim = high_resolution_clock::now();
+        cout << "Instância com " << p.numNos << " nós (coordenadas euclidianas) gravada em " << saida
+             << " (semente " << p.semente << ")" << endl;
+        cout << "Tempo de execução: " << duration_cast<milliseconds>(fim - inicio).count() << " ms" << endl;
+        return 0;
+    }
+
+    vector<Bloco> blocos = dividirEmBlocos(p.numNos, 1 << 20);
+
+    // 1a passada: conta os arcos de cada bloco (o formato exige o total antes dos arcos)
+    long long arcosClientes = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:arcosClientes)
+    for (size_t b = 0; b < blocos.size(); b++) {
+        for (int i = blocos[b].linhaInicio; i < blocos[b].linhaFim; i++) {
+            for (int j = i + 1; j < p.numNos; j++) {
+                if (pesoDoArco(p, i, j) != 0) arcosClientes++;
+            }
+        }
+    }
+    long long numArcos = 2LL * (p.numNos - 1) + arcosClientes;
+
+    FILE* arquivo = fopen(saida.c_str(), "wb");
+    if (!arquivo) {
+        cerr << "Erro ao abrir o arquivo " << saida << endl;
+        return 1;
+    }
+
+    // Cabeçalho, demandas e arcos do depósito (O(n))
+    string buffer;
+    if (binario) {
+        int32_t versao = 1, numNos = p.numNos;
+        buffer.append("VRPB", 4);
+        buffer.append(reinterpret_cast<const char*>(&versao), sizeof(versao));
+        buffer.append(reinterpret_cast<const char*>(&numNos), sizeof(numNos));
+        for (int i = 1; i < p.numNos; i++) {
+            int32_t demanda = demandaDoNo(p, i);
+            buffer.append(reinterpret_cast<const char*>(&demanda), sizeof(demanda));
+        }
+        int64_t total = numArcos;
+        buffer.append(reinterpret_cast<const char*>(&total), sizeof(total));
+        for (int i = 1; i < p.numNos; i++) {
+            int peso = pesoDoDeposito(p, i);
+            escreverBinario(buffer, 0, i, peso);
+            escreverBinario(buffer, i, 0, peso);   // distância de volta ao depósito é a mesma
+        }
+    } else {
+        buffer += to_string(p.numNos) + "\n";
+        for (int i = 1; i < p.numNos; i++) {
+            buffer += to_string(i) + " " + to_string(demandaDoNo(p, i)) + "\n";
+        }
+        buffer += to_string(numArcos) + "\n";
+        for (int i = 1; i < p.numNos; i++) {
+            int peso = pesoDoDeposito(p, i);
+            escreverTexto(buffer, 0, i, peso);
+            escreverTexto(buffer, i, 0, peso);
+        }
+    }
+    fwrite(buffer.data(), 1, buffer.size(), arquivo);
+
+    // 2a passada: gera lotes de blocos em paralelo e grava cada lote em ordem antes de gerar o próximo,
+    // então a memória usada é limitada ao tamanho de um lote
+    int numThreads = omp_get_max_threads();
+    size_t tamanhoLote = 2 * numThreads;
+    vector<string> buffers(tamanhoLote);
+    for (size_t loteInicio = 0; loteInicio < blocos.size(); loteInicio += tamanhoLote) {
+        size_t loteFim = min(blocos.size(), loteInicio + tamanhoLote);
+
+        #pragma omp parallel for schedule(dynamic)
+        for (size_t b = loteInicio; b < loteFim; b++) {
+            gerarBloco(p, blocos[b], binario, buffers[b - loteInicio]);
+        }
+
+        for (size_t b = loteInicio; b < loteFim; b++) {
+            fwrite(buffers[b - loteInicio].data(), 1, buffers[b - loteInicio].size(), arquivo);
+        }
+    }
+    fclose(arquivo);
+
+    auto fim = high_resolution_clock::now();
+    cout << "Instância com " << p.numNos << " nós e " << numArcos << " arcos gravada em " << saida
+         << " (semente " << p.semente << ")" << endl;
+    cout << "Tempo de execução: " << duration_cast<milliseconds>(fim - inicio).count() << " ms" << endl;
+
+    return 0;
+}
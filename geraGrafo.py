@@ -1,4 +1,5 @@
 import random
+import sys
 # from networkx import set_node_attributes
 
 def gerar_dicionario_demandas(N):
@@ -28,7 +29,7 @@ def gerar_entradas_grafo(num_nos, max_peso=100, probabilidade=0.25):
         grafo[(i, 0)] = grafo[(0, i)]  # Assume que a distância de volta ao depósito é a mesma
 
     # Gerar pesos para arestas entre todos os outros pares de nós
-    for i in range(1, num_nos+1):
+    for i in range(1, num_nos):
         for j in range(i+1, num_nos):
             if random.random() > (1 - probabilidade):  # Verifica a probabilidade
                 peso = random.randint(1, max_peso)
@@ -40,6 +41,10 @@ def gerar_entradas_grafo(num_nos, max_peso=100, probabilidade=0.25):
 #             Exemplo de uso
 ############################################
 num_nos = 10                                   # Número total de nós incluindo o depósito
+if len(sys.argv) > 1:
+    num_nos = int(sys.argv[1])
+if len(sys.argv) > 2:
+    random.seed(int(sys.argv[2]))              # Semente opcional, para instâncias reprodutíveis
 demandas = gerar_dicionario_demandas(num_nos)  # Gera as demandas para cada nó
 grafo = gerar_entradas_grafo(num_nos)          # Gera o grafo que representa os locais e custos entre eles
 
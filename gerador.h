@@ -0,0 +1,68 @@
+#ifndef GERADOR_H
+#define GERADOR_H
+
+#include <cstdint>
+
+// Sorteios da geração de instâncias, com a mesma distribuição do geraGrafo.py:
+// demandas de 1 a 10 para os nós 1..N-1, arcos do depósito simétricos com peso de 1 a maxPeso
+// e arcos i -> j (i < j, entre clientes) com probabilidade 'probabilidade'.
+//
+// Cada valor é função apenas de (semente, nó ou arco), e não da ordem em que é sorteado. Assim qualquer
+// thread pode gerar qualquer trecho do grafo e a instância é a mesma para a mesma semente,
+// independente do número de threads.
+
+// Finalizador do splitmix64
+inline uint64_t misturarBits(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Fluxos independentes de números aleatórios, um para cada tipo de sorteio
+enum FluxoSorteio : uint64_t { FLUXO_DEMANDA = 1, FLUXO_PESO_DEPOSITO = 2, FLUXO_EXISTE_ARCO = 3, FLUXO_PESO_ARCO = 4,
+                            FLUXO_COORDENADA = 5 };
+
+inline uint64_t sortear(uint64_t semente, uint64_t fluxo, uint64_t indice) {
+    return misturarBits(misturarBits(semente ^ (fluxo << 56)) ^ indice);
+}
+
+// Inteiro uniforme em [1, maximo]
+inline int sortearEntre1e(uint64_t bits, int maximo) {
+    return (int)(((bits >> 32) * (uint64_t)maximo) >> 32) + 1;
+}
+
+// Real uniforme em [0, 1)
+inline double sortearReal(uint64_t bits) {
+    return (bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+struct ParametrosGerador {
+    int numNos = 10;                // número de nós incluindo o depósito
+    uint64_t semente = 1;
+    int maxPeso = 100;
+    double probabilidade = 0.25;
+};
+
+inline int demandaDoNo(const ParametrosGerador& p, int no) {
+    return sortearEntre1e(sortear(p.semente, FLUXO_DEMANDA, no), 10);
+}
+
+inline int pesoDoDeposito(const ParametrosGerador& p, int no) {
+    return sortearEntre1e(sortear(p.semente, FLUXO_PESO_DEPOSITO, no), p.maxPeso);
+}
+
+// Peso do arco i -> j entre clientes (i < j), ou 0 se o arco não existe
+inline int pesoDoArco(const ParametrosGerador& p, int i, int j) {
+    uint64_t indice = (uint64_t)i * (uint64_t)p.numNos + (uint64_t)j;
+    if (sortearReal(sortear(p.semente, FLUXO_EXISTE_ARCO, indice)) >= p.probabilidade) return 0;
+    return sortearEntre1e(sortear(p.semente, FLUXO_PESO_ARCO, indice), p.maxPeso);
+}
+
+// Coordenada 'eixo' (0 = x, 1 = y) do nó nas instâncias com coordenadas: uniforme no quadrado [0, maxPeso)^2,
+// para as distâncias ficarem na mesma escala dos pesos dos arcos
+inline double coordenadaDoNo(const ParametrosGerador& p, int no, int eixo) {
+    return sortearReal(sortear(p.semente, FLUXO_COORDENADA, 2ULL * (uint64_t)no + eixo)) * p.maxPeso;
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef GREEDY_H
+#define GREEDY_H
+
+#include "vrp.h"
+#include "reordenacao.h"
+
+// Heurística de Inserção Mais Próxima
+
+// Varre os clientes ainda não visitados e retorna o mais próximo de 'origem' que cabe no veículo (-1 se nenhum)
+template <typename Matriz>
+inline int encontrarMaisProximo(const Matriz& distancias, const vector<int>& demandas, const vector<bool>& visitado,
+                         int origem, int cargaAtual, int capacidade) {
+    int n = distancias.size() - 1;
+    int melhorCliente = -1;
+    int menorDistancia = numeric_limits<int>::max();
+    const auto& linha = distancias[origem];
+
+    for (int j = 1; j <= n; ++j) {
+        if (!visitado[j] && cargaAtual + demandas[j] <= capacidade) {
+            int distancia = linha[j];
+            if (distancia != 0 && distancia < menorDistancia) { // Verifica se a distância não é zero (rota válida)
+                menorDistancia = distancia;
+                melhorCliente = j;
+            }
+        }
+    }
+    return melhorCliente;
+}
+
+// Função para resolver o VRP usando a Heurística de Inserção Mais Próxima
+template <typename Matriz>
+inline vector<vector<int>> insercaoMaisProxima(const Matriz& distancias, const vector<int>& demandas, int capacidade, LimitesExecucao& limites) {
+    int n = distancias.size() - 1; // número de clientes (não inclui depósito)
+    vector<vector<int>> rotas;
+    vector<bool> visitado(n + 1, false);
+    visitado[0] = true; // o depósito é sempre visitado
+    FaseCronometrada fase("insercao");
+
+    for (int i = 1; i <= n; ++i) {
+        if (visitado[i]) continue;
+
+        vector<int> rota = {0, i};
+        visitado[i] = true;
+        int cargaAtual = demandas[i];
+
+        // com o limite atingido os clientes restantes viram rotas individuais (0 i 0), sem a busca do mais proximo
+        while (!limites.parar()) {
+            int melhorCliente = encontrarMaisProximo(distancias, demandas, visitado, rota.back(), cargaAtual, capacidade);
+
+            if (melhorCliente == -1) break;
+
+            rota.push_back(melhorCliente);
+            contar(INSERCOES_REALIZADAS);
+            visitado[melhorCliente] = true;
+            cargaAtual += demandas[melhorCliente];
+        }
+
+        rota.push_back(0); // retorna ao depósito
+        if (calcularCusto(rota, distancias) != -1) { // Verifica se a rota é válida
+            rotas.push_back(rota);
+        }
+    }
+
+    return rotas;
+}
+
+// Função para calcular o custo total de uma combinação de rotas
+template <typename Matriz>
+inline int calcularCustoTotal(const vector<vector<int>>& rotas, const Matriz& distancias) {
+    int custoTotal = 0;
+    for (const auto& rota : rotas) {
+        custoTotal += calcularCusto(rota, distancias);
+    }
+    return custoTotal;
+}
+
+template <typename Matriz>
+inline int ResolverVRPInsercaoMaisProxima(const Matriz& locais, vector<int> demandas, int capacidade, LimitesExecucao& limites,
+                                          vector<vector<int>>* rotasSaida = nullptr) {
+    auto rotas = insercaoMaisProxima(locais, demandas, capacidade, limites);
+    reordenarRotas(rotas, locais);  // melhor ordem das paradas dentro de cada rota (reordenacao.h)
+    int custoTotal = calcularCustoTotal(rotas, locais);
+    reportarMelhoria(custoTotal, limites);  // a heurística construtiva só tem uma solução completa, a final
+
+    if (limites.esgotado) {
+        cout << "Limite de execução atingido, exibindo a melhor solução encontrada" << endl;
+    }
+
+    cout << "Rotas finais:" << endl;
+    for (const auto& rota : rotas) {
+        for (int cliente : rota) {
+            cout << cliente << " ";
+        }
+        int custoRota = calcularCusto(rota, locais);
+        cout << "(Custo: " << custoRota << ")\n";
+    }
+    cout << "Custo total: " << custoTotal << endl;
+
+    if (rotasSaida) *rotasSaida = rotas;
+    return custoTotal;
+}
+
+#endif
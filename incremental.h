@@ -0,0 +1,251 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <climits>
+#include <tuple>
+
+#include "vrp.h"
+#include "reordenacao.h"
+
+// Reotimização incremental: aplica um conjunto de alterações (cliente novo, cliente cancelado, demanda nova ou custo
+// de arco novo) a uma solução já existente e repara só as rotas atingidas, em vez de resolver a instância de novo.
+//
+// 1. As alterações são aplicadas à instância e as rotas que passam pelos clientes ou arcos alterados são marcadas.
+// 2. Rotas marcadas que ficaram inviáveis (capacidade, número de paradas ou arco inexistente) perdem clientes,
+//    que vão para a lista de pendentes junto com os clientes novos.
+// 3. Cada pendente é inserido na posição mais barata de qualquer rota (ou numa rota própria 0 c 0).
+// 4. Busca local só nas rotas marcadas: cada cliente é reposicionado dentro da própria rota ou movido para outra
+//    rota quando isso reduz o custo.
+// 5. As paradas de cada rota marcada são postas na ordem ótima (Held-Karp, reordenacao.h).
+
+enum TipoAlteracao { ADICIONAR_CLIENTE, REMOVER_CLIENTE, ALTERAR_DEMANDA, ALTERAR_ARCO };
+
+struct Alteracao {
+    TipoAlteracao tipo;
+    int cliente;        // cliente alterado, ou origem do arco em ALTERAR_ARCO
+    int valor = 0;      // demanda nova (ADICIONAR_CLIENTE, ALTERAR_DEMANDA) ou custo do arco (0 remove o arco)
+    int destino = -1;   // destino do arco em ALTERAR_ARCO
+};
+
+struct ResultadoIncremental {
+    vector<vector<int>> rotas;
+    int custo = 0;
+    vector<int> naoAtendidos;   // clientes sem nenhuma posição viável (faltam arcos)
+    int rotasAfetadas = 0;
+};
+
+// Custo de inserir 'cliente' entre rota[posicao-1] e rota[posicao] (INT_MAX se algum arco não existe)
+inline int custoInsercao(const vector<int>& rota, int posicao, int cliente, const vector<vector<int>>& distancias) {
+    int a = rota[posicao - 1], b = rota[posicao];
+    if (distancias[a][cliente] == 0 || distancias[cliente][b] == 0) return INT_MAX;
+    return distancias[a][cliente] + distancias[cliente][b] - distancias[a][b];
+}
+
+// Custo de retirar o cliente da posição (negativo = economia); INT_MAX se o arco que fecha o buraco não existe
+inline int custoRemocao(const vector<int>& rota, int posicao, const vector<vector<int>>& distancias) {
+    int a = rota[posicao - 1], c = rota[posicao], b = rota[posicao + 1];
+    if (a != b && distancias[a][b] == 0) return INT_MAX;
+    int fechamento = (a == b) ? 0 : distancias[a][b];
+    return fechamento - distancias[a][c] - distancias[c][b];
+}
+
+// Reposiciona cada cliente da rota no melhor lugar da própria rota até não haver melhoria (rotas são curtas)
+inline void reposicionarNaRota(vector<int>& rota, const vector<vector<int>>& distancias) {
+    bool melhorou = true;
+    while (melhorou) {
+        melhorou = false;
+        for (size_t i = 1; i + 1 < rota.size(); i++) {
+            int remocao = custoRemocao(rota, i, distancias);
+            if (remocao == INT_MAX) continue;
+            int cliente = rota[i];
+            vector<int> semCliente = rota;
+            semCliente.erase(semCliente.begin() + i);
+            for (size_t p = 1; p < semCliente.size(); p++) {
+                if (p == i) continue;
+                int insercao = custoInsercao(semCliente, p, cliente, distancias);
+                if (insercao != INT_MAX && remocao + insercao < 0) {
+                    semCliente.insert(semCliente.begin() + p, cliente);
+                    rota = semCliente;
+                    melhorou = true;
+                    break;
+                }
+            }
+            if (melhorou) break;
+        }
+    }
+}
+
+inline ResultadoIncremental reotimizar(const vector<vector<int>>& solucao, vector<int>& demandas, vector<vector<int>>& distancias,
+                                       int capacidade, int maxClientes, const vector<Alteracao>& alteracoes) {
+    ResultadoIncremental resultado;
+    vector<vector<int>>& rotas = resultado.rotas;
+    rotas = solucao;
+    if (maxClientes <= 0) maxClientes = INT_MAX;
+
+    // garante que a instância tem o nó 'no' (clientes novos podem estar além da matriz atual)
+    auto garantirNo = [&](int no) {
+        if (no < (int)distancias.size()) return;
+        distancias.resize(no + 1);
+        for (auto& linha : distancias) linha.resize(no + 1, 0);
+        demandas.resize(no + 1, 0);
+    };
+
+    // rota de cada cliente
+    vector<int> rotaDoCliente(distancias.size(), -1);
+    for (size_t r = 0; r < rotas.size(); r++) {
+        for (size_t i = 1; i + 1 < rotas[r].size(); i++) rotaDoCliente[rotas[r][i]] = r;
+    }
+    auto localizar = [&](int cliente) { return cliente < (int)rotaDoCliente.size() ? rotaDoCliente[cliente] : -1; };
+
+    vector<bool> afetada(rotas.size(), false);
+    vector<int> pendentes;
+    auto retirar = [&](int r, size_t posicao) {
+        int cliente = rotas[r][posicao];
+        rotas[r].erase(rotas[r].begin() + posicao);
+        rotaDoCliente[cliente] = -1;
+        return cliente;
+    };
+
+    // 1. aplica as alterações e marca as rotas atingidas
+    for (const Alteracao& alteracao : alteracoes) {
+        int c = alteracao.cliente;
+        if (alteracao.tipo == ALTERAR_ARCO) {
+            int d = alteracao.destino;
+            garantirNo(max(c, d));
+            rotaDoCliente.resize(distancias.size(), -1);
+            distancias[c][d] = alteracao.valor;
+            // só a rota que contém as duas pontas pode usar o arco; as rotas das pontas são marcadas para que a busca
+            // local reconsidere o arco (removido, mais caro ou mais barato)
+            for (int ponta : {c, d}) {
+                int r = ponta != 0 ? localizar(ponta) : -1;
+                if (r >= 0) afetada[r] = true;
+            }
+        } else if (alteracao.tipo == ALTERAR_DEMANDA) {
+            garantirNo(c);
+            demandas[c] = alteracao.valor;
+            int r = localizar(c);
+            if (r >= 0) afetada[r] = true;
+        } else if (alteracao.tipo == REMOVER_CLIENTE) {
+            // antes de localizar: um cliente adicionado no mesmo lote ainda está só nos pendentes
+            pendentes.erase(remove(pendentes.begin(), pendentes.end(), c), pendentes.end());
+            int r = localizar(c);
+            if (r < 0) continue;
+            afetada[r] = true;
+            retirar(r, find(rotas[r].begin(), rotas[r].end(), c) - rotas[r].begin());
+        } else if (alteracao.tipo == ADICIONAR_CLIENTE) {
+            garantirNo(c);
+            rotaDoCliente.resize(distancias.size(), -1);
+            demandas[c] = alteracao.valor;
+            if (localizar(c) < 0 && find(pendentes.begin(), pendentes.end(), c) == pendentes.end()) pendentes.push_back(c);
+        }
+    }
+    for (bool a : afetada) resultado.rotasAfetadas += a;
+
+    // primeiro arco da rota que não existe mais (removido ou com custo 0), ou rota.size() se todos existem
+    auto arcoAusente = [&](const vector<int>& rota) {
+        for (size_t k = 0; k + 1 < rota.size(); k++) {
+            if (distancias[rota[k]][rota[k + 1]] == 0) return k;
+        }
+        return rota.size();
+    };
+
+    // 2. esvazia as rotas atingidas até ficarem viáveis. Um arco ausente só se resolve tirando uma das suas pontas;
+    // excesso de carga ou de paradas, retirando primeiro o cliente cuja saída mais economiza
+    for (size_t r = 0; r < rotas.size(); r++) {
+        if (!afetada[r]) continue;
+        vector<int>& rota = rotas[r];
+        size_t k;
+        while (rota.size() > 2 && (k = arcoAusente(rota)) < rota.size()) {
+            size_t posicao;
+            if (k == 0) posicao = 1;                            // arco saindo do depósito: sai o primeiro cliente
+            else if (k + 2 == rota.size()) posicao = k;         // arco voltando ao depósito: sai o último
+            else posicao = custoRemocao(rota, k, distancias) <= custoRemocao(rota, k + 1, distancias) ? k : k + 1;
+            pendentes.push_back(retirar(r, posicao));
+        }
+        while (rota.size() > 2 && (cargaRota(rota, demandas) > capacidade || (int)rota.size() - 2 > maxClientes)) {
+            size_t melhorPosicao = 0;
+            int melhorCusto = INT_MAX;
+            for (size_t i = 1; i + 1 < rota.size(); i++) {
+                int custo = custoRemocao(rota, i, distancias);
+                if (custo < melhorCusto) { melhorCusto = custo; melhorPosicao = i; }
+            }
+            if (melhorPosicao == 0) {
+                // nenhuma retirada isolada deixa a rota fechada: todos os clientes voltam para a fila
+                while (rota.size() > 2) pendentes.push_back(retirar(r, 1));
+                break;
+            }
+            pendentes.push_back(retirar(r, melhorPosicao));
+        }
+    }
+
+    vector<int> cargas(rotas.size());
+    for (size_t r = 0; r < rotas.size(); r++) cargas[r] = cargaRota(rotas[r], demandas);
+
+    // melhor posição viável para o cliente fora da rota 'excluir': (rota, posição, custo)
+    auto melhorPosicao = [&](int cliente, int excluir) {
+        tuple<int, int, int> melhor(-1, -1, INT_MAX);
+        for (size_t r = 0; r < rotas.size(); r++) {
+            if ((int)r == excluir || rotas[r].size() < 3) continue;
+            if (cargas[r] + demandas[cliente] > capacidade || (int)rotas[r].size() - 2 >= maxClientes) continue;
+            for (size_t p = 1; p < rotas[r].size(); p++) {
+                int custo = custoInsercao(rotas[r], p, cliente, distancias);
+                if (custo < get<2>(melhor)) melhor = make_tuple(r, p, custo);
+            }
+        }
+        return melhor;
+    };
+    auto inserir = [&](int cliente, int r, int posicao) {
+        rotas[r].insert(rotas[r].begin() + posicao, cliente);
+        cargas[r] += demandas[cliente];
+        rotaDoCliente[cliente] = r;
+        afetada[r] = true;
+    };
+
+    // 3. inserção mais barata dos pendentes, os de maior demanda primeiro
+    sort(pendentes.begin(), pendentes.end(), [&](int a, int b) { return demandas[a] > demandas[b]; });
+    for (int cliente : pendentes) {
+        auto [r, posicao, custo] = melhorPosicao(cliente, -1);
+        bool propriaViavel = distancias[0][cliente] != 0 && distancias[cliente][0] != 0 && demandas[cliente] <= capacidade;
+        int custoPropria = propriaViavel ? distancias[0][cliente] + distancias[cliente][0] : INT_MAX;
+        if (r >= 0 && custo <= custoPropria) {
+            inserir(cliente, r, posicao);
+        } else if (propriaViavel) {
+            rotas.push_back({0, 0});
+            cargas.push_back(0);
+            afetada.push_back(false);
+            inserir(cliente, rotas.size() - 1, 1);
+        } else {
+            resultado.naoAtendidos.push_back(cliente);
+        }
+    }
+
+    // 4. busca local nas rotas atingidas: reposiciona dentro da rota e tenta mover cada cliente para outra rota
+    for (size_t r = 0; r < rotas.size(); r++) {
+        if (!afetada[r]) continue;
+        reposicionarNaRota(rotas[r], distancias);
+        for (size_t i = 1; i + 1 < rotas[r].size(); ) {
+            int cliente = rotas[r][i];
+            int remocao = custoRemocao(rotas[r], i, distancias);
+            auto [destino, posicao, custo] = remocao == INT_MAX ? make_tuple(-1, -1, INT_MAX) : melhorPosicao(cliente, r);
+            if (destino >= 0 && remocao + custo < 0) {
+                retirar(r, i);
+                cargas[r] -= demandas[cliente];
+                inserir(cliente, destino, posicao);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    // 5. ordem ótima das paradas nas rotas atingidas (reordenacao.h)
+    AreaHeldKarp areaReordenacao;
+    for (size_t r = 0; r < rotas.size(); r++) {
+        if (afetada[r] && reordenarRota(rotas[r], distancias, areaReordenacao) > 0) contar(ROTAS_REORDENADAS);
+    }
+
+    rotas.erase(remove_if(rotas.begin(), rotas.end(), [](const vector<int>& rota) { return rota.size() < 3; }), rotas.end());
+    for (const auto& rota : rotas) resultado.custo += calcularCusto(rota, distancias);
+    return resultado;
+}
+
+#endif
@@ -0,0 +1,255 @@
+#ifndef INSTRUMENTACAO_H
+#define INSTRUMENTACAO_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+#include "rastreamento.h"
+
+// Instrumentação leve dos resolvedores: cronômetros por fase, contadores por thread e pico de memória (RSS),
+// gravados em JSON ao final do programa quando ativada com --estatisticas <arquivo.json>.
+// Desativada, cada ponto de medição custa só a leitura de um bool.
+// Com --rastreamento <arquivo.json> as fases e as seções críticas também vão para a linha do tempo (rastreamento.h).
+
+enum Contador {
+    PERMUTACOES_VISITADAS,
+    ROTAS_ACEITAS,
+    DUPLICATAS_REJEITADAS,
+    COMBINACOES_VISITADAS,
+    COMBINACOES_PODADAS,          // rejeitadas por sobreposição ou por não cobrirem todos os nós
+    ITINERARIOS_AVALIADOS,
+    ECONOMIAS_AVALIADAS,
+    FUSOES_REALIZADAS,
+    INSERCOES_REALIZADAS,
+    ENTRADAS_SECAO_CRITICA,
+    NS_SECAO_CRITICA,             // tempo dentro (e esperando) das seções críticas
+    SEGMENTOS_EM_DISCO,           // vetores que passaram para um segmento mapeado (memoriaexterna.h)
+    GRUPOS_RESOLVIDOS,            // subinstâncias da decomposição (decomposicao.h)
+    REALOCACOES_FRONTEIRA,        // clientes movidos entre grupos vizinhos no reparo de fronteira
+    ROTAS_PODADAS,                // rotas descartadas na geração pela incumbente (pipeline.h)
+    ESPERAS_FILA,                 // vezes em que uma etapa do pipeline encontrou a fila seguinte cheia
+    ROTAS_REORDENADAS,            // rotas melhoradas pela reordenação exata das paradas (reordenacao.h)
+    VIZINHANCAS_RESOLVIDAS,       // vizinhanças de rotas resolvidas pela busca global no polimento (polimento.h)
+    VIZINHANCAS_MELHORADAS,
+    NUM_CONTADORES
+};
+
+inline const char* nomeContador(int c) {
+    static const char* nomes[NUM_CONTADORES] = {
+        "permutacoes_visitadas", "rotas_aceitas", "duplicatas_rejeitadas", "combinacoes_visitadas",
+        "combinacoes_podadas", "itinerarios_avaliados", "economias_avaliadas", "fusoes_realizadas",
+        "insercoes_realizadas", "entradas_secao_critica", "ns_secao_critica", "segmentos_em_disco",
+        "grupos_resolvidos", "realocacoes_fronteira", "rotas_podadas", "esperas_fila",
+        "rotas_reordenadas", "vizinhancas_resolvidas", "vizinhancas_melhoradas"};
+    return nomes[c];
+}
+
+// Alinhados a uma linha de cache: os blocos de threads vizinhas ficam lado a lado no deque e são incrementados
+// nos laços internos, então sem o alinhamento duas threads disputariam a mesma linha (falso compartilhamento)
+struct alignas(64) ContadoresThread {
+    long long valores[NUM_CONTADORES] = {0};
+};
+
+struct EstadoInstrumentacao {
+    bool ativa = false;
+    std::string arquivo;
+    std::string programa;
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+
+    std::mutex trava;
+    std::deque<ContadoresThread> porThread;     // deque: os endereços não mudam ao registrar novas threads
+    std::vector<ContadoresThread*> livres;      // blocos de threads que já terminaram (os valores continuam somando)
+    std::map<std::string, std::pair<long long, long long>> fases;   // nome -> (ns acumulados, chamadas)
+    std::map<std::string, std::string> secoes;      // seções extras do relatório, já em JSON (e.g. "numa")
+};
+
+inline EstadoInstrumentacao& instrumentacao() {
+    static EstadoInstrumentacao estado;
+    return estado;
+}
+
+inline bool instrumentacaoAtiva() {
+    return instrumentacao().ativa;
+}
+
+// Bloco de contadores de uma thread; o destrutor (na saída da thread) devolve o bloco para a lista de livres,
+// então "threads" no relatório é o maior número de threads que contaram ao mesmo tempo
+struct DonoContadoresThread {
+    ContadoresThread* bloco = nullptr;
+
+    ~DonoContadoresThread() {
+        if (!bloco) return;
+        EstadoInstrumentacao& estado = instrumentacao();
+        std::lock_guard<std::mutex> lock(estado.trava);
+        estado.livres.push_back(bloco);
+    }
+};
+
+// Contadores da thread atual, registrados na primeira vez que a thread conta algo
+inline ContadoresThread& contadoresDaThread() {
+    thread_local DonoContadoresThread dono;
+    if (!dono.bloco) {
+        EstadoInstrumentacao& estado = instrumentacao();
+        std::lock_guard<std::mutex> lock(estado.trava);
+        if (!estado.livres.empty()) {
+            dono.bloco = estado.livres.back();
+            estado.livres.pop_back();
+        } else {
+            estado.porThread.emplace_back();
+            dono.bloco = &estado.porThread.back();
+        }
+    }
+    return *dono.bloco;
+}
+
+inline void contar(Contador c, long long quantidade = 1) {
+    if (!instrumentacaoAtiva()) return;
+    contadoresDaThread().valores[c] += quantidade;
+}
+
+inline long long agoraNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Cronômetro de escopo: acumula o tempo de vida do objeto na fase 'nome' (e a registra na linha do tempo)
+struct FaseCronometrada {
+    const char* nome;
+    long long inicio;
+
+    explicit FaseCronometrada(const char* nome)
+        : nome(nome), inicio(instrumentacaoAtiva() || rastreamentoAtivo() ? agoraNs() : 0) {}
+    ~FaseCronometrada() { encerrar(); }
+
+    // Encerra a fase antes do fim do escopo (para fases seguidas na mesma função)
+    void encerrar() {
+        if (!nome) return;
+        long long agora = instrumentacaoAtiva() || rastreamentoAtivo() ? agoraNs() : 0;
+        registrarEvento(nome, inicio, agora);
+        if (!instrumentacaoAtiva()) return;
+        long long decorrido = agora - inicio;
+        EstadoInstrumentacao& estado = instrumentacao();
+        std::lock_guard<std::mutex> lock(estado.trava);
+        auto& fase = estado.fases[nome];
+        fase.first += decorrido;
+        fase.second += 1;
+        nome = nullptr;
+    }
+};
+
+// Mede a entrada e o tempo gasto numa seção crítica; usar dentro do bloco do '#pragma omp critical'
+// junto com o início medido antes do pragma (inicioEsperaSecaoCritica). entradaSecaoCritica(), na primeira
+// linha do bloco, separa na linha do tempo a espera pela trava do tempo dentro da seção.
+inline long long inicioEsperaSecaoCritica() {
+    return instrumentacaoAtiva() || rastreamentoAtivo() ? agoraNs() : 0;
+}
+
+inline long long& entradaSecaoCriticaDaThread() {
+    thread_local long long entrada = 0;
+    return entrada;
+}
+
+inline void entradaSecaoCritica() {
+    if (rastreamentoAtivo()) entradaSecaoCriticaDaThread() = agoraNs();
+}
+
+inline void fimSecaoCritica(long long inicio) {
+    if (rastreamentoAtivo()) {
+        long long agora = agoraNs();
+        long long& entrada = entradaSecaoCriticaDaThread();
+        if (entrada >= inicio) {
+            registrarEvento("espera_secao_critica", inicio, entrada);
+            registrarEvento("secao_critica", entrada, agora);
+        } else {
+            registrarEvento("secao_critica", inicio, agora);
+        }
+        entrada = 0;
+    }
+    if (!instrumentacaoAtiva()) return;
+    ContadoresThread& meus = contadoresDaThread();
+    meus.valores[ENTRADAS_SECAO_CRITICA] += 1;
+    meus.valores[NS_SECAO_CRITICA] += agoraNs() - inicio;
+}
+
+// Acrescenta ao relatório a seção 'nome' com o valor JSON 'json' (substitui uma seção anterior de mesmo nome)
+inline void registrarSecaoInstrumentacao(const std::string& nome, const std::string& json) {
+    if (!instrumentacaoAtiva()) return;
+    EstadoInstrumentacao& estado = instrumentacao();
+    std::lock_guard<std::mutex> lock(estado.trava);
+    estado.secoes[nome] = json;
+}
+
+inline long long picoRssKb() {
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;   // em KB no Linux
+}
+
+inline void escreverRelatorioInstrumentacao() {
+    EstadoInstrumentacao& estado = instrumentacao();
+    if (!estado.ativa) return;
+    std::lock_guard<std::mutex> lock(estado.trava);
+
+    FILE* saida = std::fopen(estado.arquivo.c_str(), "w");
+    if (!saida) {
+        std::fprintf(stderr, "Erro ao abrir o arquivo %s\n", estado.arquivo.c_str());
+        return;
+    }
+    long long totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - estado.inicio).count();
+    std::fprintf(saida, "{\n  \"programa\": \"%s\",\n  \"tempo_total_ms\": %lld,\n  \"pico_rss_kb\": %lld,\n  \"threads\": %zu,\n",
+                 estado.programa.c_str(), totalMs, picoRssKb(), estado.porThread.size());
+
+    std::fprintf(saida, "  \"fases\": {");
+    bool primeira = true;
+    for (const auto& fase : estado.fases) {
+        std::fprintf(saida, "%s\n    \"%s\": {\"ms\": %.3f, \"chamadas\": %lld}", primeira ? "" : ",",
+                     fase.first.c_str(), fase.second.first / 1e6, fase.second.second);
+        primeira = false;
+    }
+    std::fprintf(saida, "\n  },\n  \"contadores\": {");
+    for (int c = 0; c < NUM_CONTADORES; c++) {
+        long long total = 0;
+        for (const auto& t : estado.porThread) total += t.valores[c];
+        std::fprintf(saida, "%s\n    \"%s\": {\"total\": %lld, \"por_thread\": [", c == 0 ? "" : ",", nomeContador(c), total);
+        for (size_t t = 0; t < estado.porThread.size(); t++) {
+            std::fprintf(saida, "%s%lld", t == 0 ? "" : ", ", estado.porThread[t].valores[c]);
+        }
+        std::fprintf(saida, "]}");
+    }
+    std::fprintf(saida, "\n  }");
+    for (const auto& secao : estado.secoes) {
+        std::fprintf(saida, ",\n  \"%s\": %s", secao.first.c_str(), secao.second.c_str());
+    }
+    std::fprintf(saida, "\n}\n");
+    std::fclose(saida);
+}
+
+// Ativa a instrumentação se houver --estatisticas <arquivo> na linha de comando; o relatório é gravado na saída do programa.
+// Também lê --rastreamento <arquivo> (rastreamento.h).
+inline void LerInstrumentacao(int argc, char* argv[], const std::string& programa, const std::string& sufixo = "") {
+    LerRastreamento(argc, argv, programa);
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--estatisticas") {
+            EstadoInstrumentacao& estado = instrumentacao();
+            estado.ativa = true;
+            // o sufixo (e.g. ".rank1" no MPI) vai antes da extensão .json
+            estado.arquivo = argv[i + 1];
+            size_t ponto = estado.arquivo.rfind(".json");
+            if (ponto != std::string::npos && ponto + 5 == estado.arquivo.size()) {
+                estado.arquivo.insert(ponto, sufixo);
+            } else {
+                estado.arquivo += sufixo;
+            }
+            estado.programa = programa;
+            std::atexit(escreverRelatorioInstrumentacao);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,239 @@
+#ifndef LIMITANTES_H
+#define LIMITANTES_H
+
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <iostream>
+
+// Limitantes inferiores do custo de qualquer solução viável da instância, para dizer a que distância do ótimo
+// está uma solução (gap) e para podar a busca exata.
+//
+// Solução viável: cada cliente em exatamente uma rota 0 ... 0, só arcos existentes (peso != 0), carga de cada rota
+// até a capacidade e, se maxClientes > 0, no máximo maxClientes clientes por rota.
+//
+// - arcos: cada cliente sai e é entrado exatamente uma vez, e o depósito tem uma saída e uma entrada por veículo,
+//   com pelo menos minVeiculos = max(demanda total / capacidade, clientes / maxClientes) veículos;
+// - atribuição: relaxação em que só as restrições de grau valem (sucessor e antecessor únicos), resolvida pelo
+//   método húngaro com minVeiculos cópias obrigatórias do depósito e cópias opcionais para os veículos extras.
+//   É O(N^3) com N = 2 * clientes, então só é calculada até maxNosAtribuicao nós.
+
+const long long CUSTO_PROIBIDO = 1LL << 40;   // arco inexistente na relaxação de atribuição
+const int MAX_NOS_LIMITANTE = 20000;            // acima disso imprimirLimitante não calcula nem o limitante de arcos (O(n^2))
+
+struct Limitante {
+    long long valor = 0;            // o maior dos limitantes calculados
+    long long arcos = 0;
+    long long atribuicao = -1;      // -1 se não foi calculado (instância grande demais)
+    int minVeiculos = 0;
+    bool inviavel = false;          // nenhuma solução viável: cliente sem arco de entrada/saída ou com demanda acima da capacidade
+};
+
+inline int veiculosMinimos(const std::vector<int>& demandas, int numVertices, int capacidade, int maxClientes) {
+    long long demandaTotal = 0;
+    for (int i = 1; i < numVertices; i++) demandaTotal += demandas[i];
+    int clientes = numVertices - 1;
+    int veiculos = clientes > 0 ? 1 : 0;
+    if (capacidade > 0) veiculos = std::max<long long>(veiculos, (demandaTotal + capacidade - 1) / capacidade);
+    if (maxClientes > 0) veiculos = std::max(veiculos, (clientes + maxClientes - 1) / maxClientes);
+    return veiculos;
+}
+
+// Soma dos 'k' menores valores de 'valores' (todos, se houver menos de k)
+inline long long somaDosMenores(std::vector<long long> valores, int k) {
+    k = std::min<int>(k, valores.size());
+    std::nth_element(valores.begin(), valores.begin() + k, valores.end());
+    long long soma = 0;
+    for (int i = 0; i < k; i++) soma += valores[i];
+    return soma;
+}
+
+// Maior entre a soma dos arcos de saída mais baratos e a soma dos arcos de entrada mais baratos
+template <typename Matriz>
+inline long long limitanteArcos(const Matriz& distancias, int numVertices, int minVeiculos, bool& inviavel) {
+    long long saidas = 0, entradas = 0;
+    for (int i = 1; i < numVertices; i++) {
+        long long menorSaida = LLONG_MAX, menorEntrada = LLONG_MAX;
+        for (int j = 0; j < numVertices; j++) {
+            if (j == i) continue;
+            int saida = distancias[i][j], entrada = distancias[j][i];
+            if (saida != 0 && saida < menorSaida) menorSaida = saida;
+            if (entrada != 0 && entrada < menorEntrada) menorEntrada = entrada;
+        }
+        if (menorSaida == LLONG_MAX || menorEntrada == LLONG_MAX) {
+            inviavel = true;
+            return 0;
+        }
+        saidas += menorSaida;
+        entradas += menorEntrada;
+    }
+    // o depósito sai e é entrado uma vez por veículo, sempre em clientes diferentes
+    std::vector<long long> saidasDeposito, entradasDeposito;
+    for (int j = 1; j < numVertices; j++) {
+        if (distancias[0][j] != 0) saidasDeposito.push_back(distancias[0][j]);
+        if (distancias[j][0] != 0) entradasDeposito.push_back(distancias[j][0]);
+    }
+    if ((int)saidasDeposito.size() < minVeiculos || (int)entradasDeposito.size() < minVeiculos) {
+        inviavel = true;
+        return 0;
+    }
+    saidas += somaDosMenores(saidasDeposito, minVeiculos);
+    entradas += somaDosMenores(entradasDeposito, minVeiculos);
+    return std::max(saidas, entradas);
+}
+
+// Atribuição de custo mínimo (método húngaro com potenciais) da matriz quadrada 'custo'
+inline long long atribuicaoMinima(const std::vector<std::vector<long long>>& custo) {
+    int n = custo.size();
+    std::vector<long long> u(n + 1, 0), v(n + 1, 0), menor(n + 1);
+    std::vector<int> coluna(n + 1, 0), caminho(n + 1, 0);   // coluna[j]: linha atribuída à coluna j (1-indexado)
+    std::vector<char> usada(n + 1);
+    for (int i = 1; i <= n; i++) {
+        coluna[0] = i;
+        int j0 = 0;
+        std::fill(menor.begin(), menor.end(), LLONG_MAX);
+        std::fill(usada.begin(), usada.end(), 0);
+        do {
+            usada[j0] = 1;
+            int i0 = coluna[j0], j1 = 0;
+            long long delta = LLONG_MAX;
+            for (int j = 1; j <= n; j++) {
+                if (usada[j]) continue;
+                long long reduzido = custo[i0 - 1][j - 1] - u[i0] - v[j];
+                if (reduzido < menor[j]) {
+                    menor[j] = reduzido;
+                    caminho[j] = j0;
+                }
+                if (menor[j] < delta) {
+                    delta = menor[j];
+                    j1 = j;
+                }
+            }
+            for (int j = 0; j <= n; j++) {
+                if (usada[j]) {
+                    u[coluna[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    menor[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (coluna[j0] != 0);
+        do {
+            int j1 = caminho[j0];
+            coluna[j0] = coluna[j1];
+            j0 = j1;
+        } while (j0);
+    }
+    long long total = 0;
+    for (int j = 1; j <= n; j++) total += custo[coluna[j] - 1][j - 1];
+    return total;
+}
+
+// Relaxação de atribuição; linhas e colunas: clientes, depósitos obrigatórios, depósitos opcionais.
+// Retorna CUSTO_PROIBIDO ou mais se nem a relaxação tem solução.
+template <typename Matriz>
+inline long long limitanteAtribuicao(const Matriz& distancias, int numVertices, int minVeiculos) {
+    int clientes = numVertices - 1;
+    int n = 2 * clientes;           // até um veículo por cliente: clientes - minVeiculos depósitos opcionais
+    auto no = [&](int indice) { return indice < clientes ? indice + 1 : 0; };
+    auto obrigatorio = [&](int indice) { return indice >= clientes && indice < clientes + minVeiculos; };
+
+    std::vector<std::vector<long long>> custo(n, std::vector<long long>(n, CUSTO_PROIBIDO));
+    for (int a = 0; a < n; a++) {
+        for (int b = 0; b < n; b++) {
+            int origem = no(a), destino = no(b);
+            if (origem == 0 && destino == 0) {
+                // veículo não usado: só entre depósitos opcionais
+                if (!obrigatorio(a) && !obrigatorio(b)) custo[a][b] = 0;
+            } else if (origem != destino && distancias[origem][destino] != 0) {
+                custo[a][b] = distancias[origem][destino];
+            }
+        }
+    }
+    return atribuicaoMinima(custo);
+}
+
+// maxClientes = 0: sem limite de clientes por rota (como na inserção mais próxima)
+template <typename Matriz>
+inline Limitante calcularLimitante(const Matriz& distancias, const std::vector<int>& demandas, int capacidade,
+                                   int maxClientes = 0, int maxNosAtribuicao = 200) {
+    Limitante limitante;
+    int numVertices = distancias.size();
+    if (numVertices <= 1) return limitante;
+    for (int i = 1; i < numVertices; i++) {
+        if (demandas[i] > capacidade) limitante.inviavel = true;
+    }
+    limitante.minVeiculos = veiculosMinimos(demandas, numVertices, capacidade, maxClientes);
+    if (limitante.inviavel) return limitante;
+
+    limitante.arcos = limitanteArcos(distancias, numVertices, limitante.minVeiculos, limitante.inviavel);
+    limitante.valor = limitante.arcos;
+    if (limitante.inviavel) return limitante;
+
+    if (numVertices <= maxNosAtribuicao) {
+        limitante.atribuicao = limitanteAtribuicao(distancias, numVertices, limitante.minVeiculos);
+        if (limitante.atribuicao >= CUSTO_PROIBIDO) {
+            limitante.inviavel = true;
+        } else {
+            limitante.valor = std::max(limitante.valor, limitante.atribuicao);
+        }
+    }
+    return limitante;
+}
+
+// true se 'rotas' é uma solução viável no sentido acima (só então o gap tem significado)
+template <typename Matriz>
+inline bool solucaoViavel(const std::vector<std::vector<int>>& rotas, const Matriz& distancias, const std::vector<int>& demandas,
+                          int capacidade, int maxClientes = 0) {
+    int numVertices = distancias.size();
+    std::vector<char> atendido(numVertices, 0);
+    int atendidos = 0;
+    for (const auto& rota : rotas) {
+        if (rota.size() < 3 || rota.front() != 0 || rota.back() != 0) return false;
+        int carga = 0;
+        for (size_t i = 0; i + 1 < rota.size(); i++) {
+            if (distancias[rota[i]][rota[i + 1]] == 0) return false;
+            if (i == 0) continue;
+            int cliente = rota[i];
+            if (cliente <= 0 || cliente >= numVertices || atendido[cliente]) return false;
+            atendido[cliente] = 1;
+            atendidos++;
+            carga += demandas[cliente];
+        }
+        if (carga > capacidade) return false;
+        if (maxClientes > 0 && (int)rota.size() - 2 > maxClientes) return false;
+    }
+    return atendidos == numVertices - 1;
+}
+
+// Gap relativo em %: (custo - limitante) / custo
+inline double gapPercentual(long long custo, const Limitante& limitante) {
+    if (custo <= 0) return 0.0;
+    return 100.0 * (custo - limitante.valor) / custo;
+}
+
+// Imprime o limitante e o gap da solução, no formato dos programas isolados
+template <typename Matriz>
+inline void imprimirLimitante(long long custo, const std::vector<std::vector<int>>& rotas, const Matriz& distancias,
+                              const std::vector<int>& demandas, int capacidade, int maxClientes = 0) {
+    if ((int)distancias.size() > MAX_NOS_LIMITANTE) {
+        std::cout << "Limitante inferior: não calculado (mais de " << MAX_NOS_LIMITANTE << " nós)" << std::endl;
+        return;
+    }
+    Limitante limitante = calcularLimitante(distancias, demandas, capacidade, maxClientes);
+    if (limitante.inviavel) {
+        std::cout << "Limitante inferior: instância sem solução viável" << std::endl;
+        return;
+    }
+    std::cout << "Limitante inferior: " << limitante.valor << " (arcos " << limitante.arcos;
+    if (limitante.atribuicao >= 0) std::cout << ", atribuição " << limitante.atribuicao;
+    std::cout << ", mínimo de " << limitante.minVeiculos << " veículos)" << std::endl;
+    if (solucaoViavel(rotas, distancias, demandas, capacidade, maxClientes)) {
+        std::cout << "Gap: " << gapPercentual(custo, limitante) << "%" << std::endl;
+    } else {
+        std::cout << "Gap: indefinido (a solução não atende todos os clientes com rotas válidas)" << std::endl;
+    }
+}
+
+#endif
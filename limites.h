@@ -0,0 +1,122 @@
+#ifndef LIMITES_H
+#define LIMITES_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rastreamento.h"
+
+// Limites de execução compartilhados por todos os resolvedores.
+// tempoLimiteMs = 0 e maxIteracoes = 0 significam "sem limite" (comportamento original).
+struct LimitesExecucao {
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    long long tempoLimiteMs = 0;
+    long long maxIteracoes = 0;
+    bool reportar = true;           // false no modo lote, onde só interessa o resultado final
+    std::atomic<long long> iteracoes{0};
+    std::atomic<bool> esgotado{false};
+    mutable std::atomic<int> melhorReportado{INT_MAX};     // menor custo já impresso por reportarMelhoria
+
+    long long decorridoMs() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    // Conta 'passos' iterações e retorna true se algum limite foi atingido.
+    // O relógio só é consultado a cada 1024 iterações para não pesar no laço interno.
+    bool parar(long long passos = 1) {
+        if (esgotado.load(std::memory_order_relaxed)) return true;
+        if (tempoLimiteMs == 0 && maxIteracoes == 0) return false;
+
+        long long antes = iteracoes.fetch_add(passos, std::memory_order_relaxed);
+        long long total = antes + passos;
+        if (maxIteracoes > 0 && total >= maxIteracoes) {
+            esgotado.store(true, std::memory_order_relaxed);
+            return true;
+        }
+        if (tempoLimiteMs > 0 && ((antes >> 10) != (total >> 10) || passos >= 1024)) {
+            if (decorridoMs() >= tempoLimiteMs) {
+                esgotado.store(true, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Versão sem contagem, para pontos de verificação fora dos laços internos
+    bool tempoEsgotado() {
+        if (esgotado.load(std::memory_order_relaxed)) return true;
+        if (tempoLimiteMs > 0 && decorridoMs() >= tempoLimiteMs) {
+            esgotado.store(true, std::memory_order_relaxed);
+        }
+        return esgotado.load(std::memory_order_relaxed);
+    }
+};
+
+// Imprime uma melhoria com o instante (ms desde o início) em que foi encontrada; custos que não são
+// estritamente menores que o menor já impresso são ignorados, então a sequência impressa só desce
+inline void reportarMelhoria(int custo, const LimitesExecucao& limites) {
+    if (!limites.reportar) return;
+    int melhor = limites.melhorReportado.load(std::memory_order_relaxed);
+    do {
+        if (custo >= melhor) return;
+    } while (!limites.melhorReportado.compare_exchange_weak(melhor, custo, std::memory_order_relaxed));
+    std::cout << "[" << limites.decorridoMs() << " ms] Melhoria: custo " << custo << std::endl;
+}
+
+// Melhor solução encontrada até o momento. Cada melhoria é impressa assim que é encontrada,
+// para que quem chama possa consumir a saída em tempo real.
+struct Incumbente {
+    std::atomic<int> custo{INT_MAX};
+    std::vector<std::vector<int>> rotas;
+    bool silencioso = false;        // e.g. ranks MPI diferentes de 0: só o rank 0 imprime as melhorias
+    std::mutex trava;
+
+    bool existe() const { return custo.load(std::memory_order_relaxed) != INT_MAX; }
+
+    // Retorna true se a solução oferecida for estritamente melhor que a atual
+    bool oferecer(int novoCusto, const std::vector<std::vector<int>>& novasRotas, const LimitesExecucao& limites) {
+        if (novoCusto < 0 || novoCusto >= custo.load(std::memory_order_relaxed)) return false;
+        long long espera = rastreamentoAtivo() ? relogioRastreamentoNs() : 0;
+        std::lock_guard<std::mutex> lock(trava);
+        if (rastreamentoAtivo()) registrarEvento("espera_incumbente", espera, relogioRastreamentoNs());
+        if (novoCusto >= custo.load(std::memory_order_relaxed)) return false;
+        custo.store(novoCusto, std::memory_order_relaxed);
+        rotas = novasRotas;
+        if (!silencioso) reportarMelhoria(novoCusto, limites);
+        return true;
+    }
+};
+
+// Valor de --tempo-limite ou --max-iteracoes: um inteiro >= 0 ocupando o argumento inteiro; encerra o programa se não for
+inline long long LerValorLimite(const std::string& opcao, const char* valor) {
+    char* fim;
+    errno = 0;
+    long long lido = std::strtoll(valor, &fim, 10);
+    if (fim == valor || *fim != '\0' || errno == ERANGE || lido < 0) {
+        std::fprintf(stderr, "%s inválido: '%s' (use um inteiro maior ou igual a zero)\n", opcao.c_str(), valor);
+        std::exit(1);
+    }
+    return lido;
+}
+
+// Lê as opções --tempo-limite <ms> e --max-iteracoes <n> da linha de comando
+inline void LerLimites(int argc, char* argv[], LimitesExecucao& limites) {
+    for (int i = 1; i < argc; i++) {
+        std::string opcao = argv[i];
+        if (opcao == "--tempo-limite" && i + 1 < argc) {
+            limites.tempoLimiteMs = LerValorLimite(opcao, argv[++i]);
+        } else if (opcao == "--max-iteracoes" && i + 1 < argc) {
+            limites.maxIteracoes = LerValorLimite(opcao, argv[++i]);
+        }
+    }
+}
+
+#endif
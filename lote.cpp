@@ -0,0 +1,185 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <omp.h>
+
+#include "resolvedores.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Modo lote: resolve muitas instâncias num único processo, distribuídas entre as threads do OpenMP.
+// Cada thread reaproveita os vetores de demandas e a matriz de distâncias de uma instância para a próxima.
+// O resultado de cada instância é gravado como uma linha JSON (JSONL) assim que fica pronto.
+//
+// O manifesto tem uma instância por linha (linhas vazias e começadas por # são ignoradas):
+//   <arquivo> [resolvedor] [capacidade] [maxParadas] [tempoLimiteMs]
+// Os campos omitidos usam os valores padrão da linha de comando. Caminhos relativos são relativos ao manifesto.
+// Uma linha com campo numérico inválido (ou campos a mais) é ignorada, com o número da linha na saída de erro.
+// No lugar do manifesto pode ser passado um diretório: todas as instâncias dele são resolvidas com os valores padrão.
+
+struct Tarefa {
+    string arquivo;
+    PedidoSolucao pedido;
+};
+
+// Lê um campo numérico do manifesto: o campo inteiro precisa ser um número entre 'minimo' e 'maximo'
+bool lerCampoInteiro(const string& campo, long long minimo, long long maximo, long long& valor) {
+    char* fim;
+    errno = 0;
+    long long lido = strtoll(campo.c_str(), &fim, 10);
+    if (campo.empty() || *fim != '\0' || errno == ERANGE || lido < minimo || lido > maximo) return false;
+    valor = lido;
+    return true;
+}
+
+vector<Tarefa> LerManifesto(const string& caminho, const PedidoSolucao& padrao) {
+    vector<Tarefa> tarefas;
+    namespace fs = std::filesystem;
+
+    if (fs::is_directory(caminho)) {
+        for (const auto& entrada : fs::directory_iterator(caminho)) {
+            if (entrada.is_regular_file()) {
+                tarefas.push_back({entrada.path().string(), padrao});
+            }
+        }
+        sort(tarefas.begin(), tarefas.end(), [](const Tarefa& a, const Tarefa& b) { return a.arquivo < b.arquivo; });
+        return tarefas;
+    }
+
+    ifstream manifesto(caminho);
+    if (!manifesto.is_open()) {
+        cerr << "Erro ao abrir o arquivo " << caminho << endl;
+        exit(1);
+    }
+    fs::path base = fs::path(caminho).parent_path();
+    string linha;
+    int numeroLinha = 0;
+    while (getline(manifesto, linha)) {
+        numeroLinha++;
+        stringstream campos(linha);
+        Tarefa tarefa;
+        tarefa.pedido = padrao;
+        if (!(campos >> tarefa.arquivo) || tarefa.arquivo[0] == '#') continue;
+        if (fs::path(tarefa.arquivo).is_relative()) {
+            tarefa.arquivo = (base / tarefa.arquivo).string();
+        }
+        string resolvedor;
+        if (campos >> resolvedor) tarefa.pedido.resolvedor = resolvedor;
+
+        // um campo que não é número rejeita a linha: com >> ele viraria 0 (e tempo limite 0 é "sem limite")
+        string campo;
+        long long capacidade = tarefa.pedido.capacidade, maxParadas = tarefa.pedido.maxParadas;
+        bool valida = true;
+        if (campos >> campo) valida = lerCampoInteiro(campo, 1, INT_MAX, capacidade);
+        if (valida && campos >> campo) valida = lerCampoInteiro(campo, 3, INT_MAX, maxParadas);
+        if (valida && campos >> campo) valida = lerCampoInteiro(campo, 0, LLONG_MAX, tarefa.pedido.tempoLimiteMs);
+        if (valida && campos >> campo) valida = false;
+        if (!valida) {
+            cerr << caminho << ":" << numeroLinha << ": campo inválido '" << campo << "', linha ignorada "
+                 << "(esperado: <arquivo> [resolvedor] [capacidade] [maxParadas] [tempoLimiteMs])" << endl;
+            continue;
+        }
+        tarefa.pedido.capacidade = capacidade;
+        tarefa.pedido.maxParadas = maxParadas;
+        tarefas.push_back(tarefa);
+    }
+    return tarefas;
+}
+
+int main(int argc, char* argv[]) {
+    PedidoSolucao padrao;
+    string entrada;
+    string saida = "resultados.jsonl";
+
+    for (int i = 1; i < argc; i++) {
+        string opcao = argv[i];
+        if (opcao == "--resolvedor" && i + 1 < argc) padrao.resolvedor = argv[++i];
+        else if (opcao == "--capacidade" && i + 1 < argc) padrao.capacidade = atoi(argv[++i]);
+        else if (opcao == "--max-paradas" && i + 1 < argc) padrao.maxParadas = atoi(argv[++i]);
+        else if (opcao == "--tempo-limite" && i + 1 < argc) padrao.tempoLimiteMs = atoll(argv[++i]);
+        else if (opcao == "--max-iteracoes" && i + 1 < argc) padrao.maxIteracoes = atoll(argv[++i]);
+        else if (opcao == "--tolerancia-gap" && i + 1 < argc) padrao.toleranciaGap = atof(argv[++i]);
+        else if (opcao == "--limitante") padrao.calcularLimitante = true;
+        else if (opcao == "--saida" && i + 1 < argc) saida = argv[++i];
+        else if ((opcao == "--estatisticas" || opcao == "--rastreamento" || opcao == "--eventos-por-thread" ||
+                  opcao == "--memoria-max" || opcao == "--dir-temporario" || opcao == "--cache") && i + 1 < argc) i++;
+        else entrada = opcao;
+    }
+    if (entrada.empty() || !resolvedorValido(padrao.resolvedor)) {
+        cerr << "uso: ./lote <manifesto|diretorio> [--resolvedor clarke|greedy|buscaglobal|portfolio] [--capacidade 15] [--max-paradas 5]"
+                " [--tempo-limite ms] [--max-iteracoes n] [--limitante] [--tolerancia-gap %] [--saida resultados.jsonl] [--estatisticas arquivo.json]"
+                " [--memoria-max MB] [--dir-temporario dir] [--cache dir]" << endl;
+        return 1;
+    }
+    LerInstrumentacao(argc, argv, "lote");
+    LerOrcamentoMemoria(argc, argv);
+    LerCache(argc, argv);
+
+    vector<Tarefa> tarefas = LerManifesto(entrada, padrao);
+    ofstream arquivo(saida);
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo " << saida << endl;
+        return 1;
+    }
+
+    auto inicio = high_resolution_clock::now();
+    int resolvidas = 0, falhas = 0;
+
+    #pragma omp parallel
+    {
+        // área de trabalho da thread, reaproveitada entre as instâncias
+        vector<int> demandas;
+        vector<vector<int>> distancias;
+        int numVertices = 0;
+
+        #pragma omp for schedule(dynamic)
+        for (size_t t = 0; t < tarefas.size(); t++) {
+            const Tarefa& tarefa = tarefas[t];
+            Solucao solucao;
+            {
+                FaseCronometrada fase("leitura");
+                solucao.erro = LerInstancia(tarefa.arquivo, numVertices, demandas, distancias);
+            }
+            if (solucao.erro.empty()) {
+                FaseCronometrada fase("resolucao");
+                solucao = resolver(tarefa.pedido, demandas, distancias);
+            }
+
+            ostringstream registro;
+            registro << "{\"instancia\": \"" << escaparJson(tarefa.arquivo) << "\", \"resolvedor\": \"" << escaparJson(tarefa.pedido.resolvedor)
+                     << "\", \"capacidade\": " << tarefa.pedido.capacidade << ", \"maxParadas\": " << tarefa.pedido.maxParadas
+                     << ", " << solucaoEmJson(solucao) << "}\n";
+
+            long long espera = inicioEsperaSecaoCritica();
+            #pragma omp critical
+            {
+                entradaSecaoCritica();
+                arquivo << registro.str();
+                if (solucao.erro.empty()) resolvidas++;
+                else falhas++;
+                fimSecaoCritica(espera);
+            }
+        }
+    }
+    arquivo.close();
+
+    auto fim = high_resolution_clock::now();
+    long long duracao = duration_cast<milliseconds>(fim - inicio).count();
+    cout << resolvidas << " instâncias resolvidas, " << falhas << " com erro, usando " << omp_get_max_threads()
+         << " threads. Resultados gravados em " << saida << endl;
+    if (cacheAtivo()) {
+        cout << "Cache: " << cacheSolucoes().acertos << " acertos, " << cacheSolucoes().faltas << " faltas" << endl;
+    }
+    cout << "Tempo de execução: " << duracao << " ms" << endl;
+
+    return 0;
+}
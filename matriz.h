@@ -0,0 +1,126 @@
+#ifndef MATRIZ_H
+#define MATRIZ_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// Matriz de distâncias compacta para as heurísticas (Clarke e Wright, inserção mais próxima).
+//
+// O tipo da célula é escolhido na carga pelo maior peso da instância: com os pesos do gerador (até 100) cada
+// célula ocupa 1 byte em vez dos 4 de um int, e a matriz é contígua em vez de uma alocação por linha.
+// Instâncias simétricas podem usar o formato triangular empacotado, com metade das células.
+//
+// A interface é a mesma de vector<vector<int>> para leitura (m[i][j] e m.size()), então os resolvedores templados
+// na matriz rodam sem alteração sobre qualquer uma das variantes.
+
+template <typename Celula, bool Simetrica>
+class MatrizCompacta {
+public:
+    // Linha da matriz triangular: m[i][j] com i e j em qualquer ordem
+    struct LinhaSimetrica {
+        const Celula* celulas;
+        size_t i, inicioI;
+        int operator[](size_t j) const {
+            return j <= i ? celulas[inicioI + j] : celulas[j * (j + 1) / 2 + i];
+        }
+    };
+
+    explicit MatrizCompacta(const std::vector<std::vector<int>>& densa) : n(densa.size()) {
+        celulas.resize(Simetrica ? n * (n + 1) / 2 : n * n);
+        for (size_t i = 0; i < n; i++) {
+            size_t limite = Simetrica ? i + 1 : n;
+            for (size_t j = 0; j < limite; j++) {
+                celulas[indice(i, j)] = static_cast<Celula>(densa[i][j]);
+            }
+        }
+    }
+
+    size_t size() const { return n; }
+    size_t bytes() const { return celulas.size() * sizeof(Celula); }
+
+    auto operator[](size_t i) const {
+        if constexpr (Simetrica) {
+            return LinhaSimetrica{celulas.data(), i, i * (i + 1) / 2};
+        } else {
+            return celulas.data() + i * n;
+        }
+    }
+
+private:
+    size_t n;
+    std::vector<Celula> celulas;
+
+    size_t indice(size_t i, size_t j) const {
+        if constexpr (Simetrica) {
+            return i >= j ? i * (i + 1) / 2 + j : j * (j + 1) / 2 + i;
+        } else {
+            return i * n + j;
+        }
+    }
+};
+
+// Maior peso, se há pesos negativos e se a matriz é simétrica (inclusive quanto à existência dos arcos)
+struct PerfilMatriz {
+    int maior = 0;
+    bool negativa = false;
+    bool simetrica = true;
+};
+
+inline PerfilMatriz perfilMatriz(const std::vector<std::vector<int>>& densa) {
+    PerfilMatriz perfil;
+    for (size_t i = 0; i < densa.size(); i++) {
+        for (size_t j = 0; j < densa.size(); j++) {
+            int valor = densa[i][j];
+            if (valor > perfil.maior) perfil.maior = valor;
+            if (valor < 0) perfil.negativa = true;
+            if (j < i && valor != densa[j][i]) perfil.simetrica = false;
+        }
+    }
+    return perfil;
+}
+
+// 'liberar' (opcional) é a própria matriz densa, liberada assim que a compacta fica pronta
+template <typename Celula, typename Funcao>
+auto chamarComMatriz(const std::vector<std::vector<int>>& densa, std::vector<std::vector<int>>* liberar, bool simetrica, Funcao&& funcao) {
+    if (simetrica) {
+        MatrizCompacta<Celula, true> matriz(densa);
+        if (liberar) std::vector<std::vector<int>>().swap(*liberar);
+        return funcao(matriz);
+    }
+    MatrizCompacta<Celula, false> matriz(densa);
+    if (liberar) std::vector<std::vector<int>>().swap(*liberar);
+    return funcao(matriz);
+}
+
+template <typename Funcao>
+auto comMatrizCompactaLiberando(const std::vector<std::vector<int>>& densa, std::vector<std::vector<int>>* liberar, Funcao&& funcao,
+                                bool permitirTriangular) {
+    PerfilMatriz perfil = perfilMatriz(densa);
+    bool triangular = permitirTriangular && perfil.simetrica;
+    if (!perfil.negativa && perfil.maior <= UINT8_MAX) {
+        return chamarComMatriz<uint8_t>(densa, liberar, triangular, std::forward<Funcao>(funcao));
+    }
+    if (!perfil.negativa && perfil.maior <= UINT16_MAX) {
+        return chamarComMatriz<uint16_t>(densa, liberar, triangular, std::forward<Funcao>(funcao));
+    }
+    return chamarComMatriz<int32_t>(densa, liberar, triangular, std::forward<Funcao>(funcao));
+}
+
+// Converte a matriz para a variante compacta que comporta os pesos da instância e chama funcao(matriz).
+// 'funcao' é um lambda genérico, instanciado para cada variante (uint8, uint16 ou int32; densa ou triangular).
+// Com permitirTriangular = false o formato triangular não é usado, mesmo para instâncias simétricas.
+template <typename Funcao>
+auto comMatrizCompacta(const std::vector<std::vector<int>>& densa, Funcao&& funcao, bool permitirTriangular = true) {
+    return comMatrizCompactaLiberando(densa, nullptr, std::forward<Funcao>(funcao), permitirTriangular);
+}
+
+// Idem, recebendo a matriz densa com std::move: ela é liberada antes de chamar 'funcao', então durante a resolução
+// só a compacta ocupa memória (a densa e a compacta coexistem apenas durante a conversão)
+template <typename Funcao>
+auto comMatrizCompacta(std::vector<std::vector<int>>&& densa, Funcao&& funcao, bool permitirTriangular = true) {
+    return comMatrizCompactaLiberando(densa, &densa, std::forward<Funcao>(funcao), permitirTriangular);
+}
+
+#endif
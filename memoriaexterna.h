@@ -0,0 +1,237 @@
+#ifndef MEMORIAEXTERNA_H
+#define MEMORIAEXTERNA_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <string>
+#include <new>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "instrumentacao.h"
+
+// Orçamento de memória para os conjuntos de sequências (poolrotas.h).
+//
+// Enquanto a soma dos vetores em memória cabe no orçamento eles são alocados normalmente; o vetor que o
+// ultrapassaria passa para um arquivo de segmento no diretório temporário, mapeado com mmap(MAP_SHARED).
+// As páginas de um segmento podem ser devolvidas ao disco pelo kernel, então a execução fica mais lenta
+// em vez de morrer por falta de memória. O espaço do segmento é reservado no disco com posix_fallocate ao criar
+// e ao crescer, para que a falta de espaço apareça ali, com mensagem, e não como SIGBUS na primeira escrita numa
+// página de um arquivo esparso. O arquivo é removido do diretório logo após ser criado: ele some
+// quando o vetor é liberado ou o processo termina, inclusive se o processo for morto.
+// Sem --memoria-max (limiteBytes = 0) nada muda.
+
+struct OrcamentoMemoria {
+    size_t limiteBytes = 0;                 // 0: sem limite
+    std::string diretorio = "/tmp";
+    std::atomic<size_t> emMemoria{0};       // bytes alocados em memória pelos vetores mapeáveis
+    std::atomic<size_t> emDisco{0};         // bytes atualmente em segmentos mapeados
+    std::atomic<int> segmentos{0};
+};
+
+inline OrcamentoMemoria& orcamentoMemoria() {
+    static OrcamentoMemoria orcamento;
+    return orcamento;
+}
+
+// --memoria-max <MB> e --dir-temporario <diretório>. Um --memoria-max que não é um número positivo termina o
+// programa: lido como 0 ele desligaria o orçamento sem aviso.
+inline void LerOrcamentoMemoria(int argc, char* argv[]) {
+    OrcamentoMemoria& orcamento = orcamentoMemoria();
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string opcao = argv[i];
+        if (opcao == "--memoria-max") {
+            const char* valor = argv[++i];
+            char* fim;
+            errno = 0;
+            double megabytes = std::strtod(valor, &fim);
+            double bytes = megabytes * (1 << 20);
+            if (fim == valor || *fim != '\0' || errno != 0 || !std::isfinite(megabytes) || bytes < 1 || bytes >= 1.8e19) {
+                std::fprintf(stderr, "--memoria-max inválido: '%s' (use um número de MB maior que zero)\n", valor);
+                std::exit(1);
+            }
+            orcamento.limiteBytes = (size_t)bytes;
+        } else if (opcao == "--dir-temporario") {
+            orcamento.diretorio = argv[++i];
+        }
+    }
+}
+
+// Vetor de elementos triviais (int, uint32_t) que fica em memória enquanto o orçamento permite e num segmento
+// mapeado depois disso. Tem a parte da interface de std::vector usada pelo PoolSequencias.
+template <typename T>
+class VetorMapeavel {
+    static_assert(std::is_trivially_copyable<T>::value, "VetorMapeavel guarda só tipos triviais");
+
+public:
+    VetorMapeavel() {}
+    VetorMapeavel(size_t n, const T& valor) { assign(n, valor); }
+    VetorMapeavel(const VetorMapeavel& outro) { copiarDe(outro); }
+    VetorMapeavel(VetorMapeavel&& outro) noexcept { tomarDe(outro); }
+    ~VetorMapeavel() { liberar(); }
+
+    VetorMapeavel& operator=(const VetorMapeavel& outro) {
+        if (this != &outro) {
+            liberar();
+            copiarDe(outro);
+        }
+        return *this;
+    }
+    VetorMapeavel& operator=(VetorMapeavel&& outro) noexcept {
+        if (this != &outro) {
+            liberar();
+            tomarDe(outro);
+        }
+        return *this;
+    }
+
+    size_t size() const { return tamanho; }
+    size_t capacity() const { return capacidade; }
+    bool empty() const { return tamanho == 0; }
+    bool mapeado() const { return descritor >= 0; }
+    T* data() { return dados; }
+    const T* data() const { return dados; }
+    T& operator[](size_t i) { return dados[i]; }
+    const T& operator[](size_t i) const { return dados[i]; }
+    T* begin() { return dados; }
+    T* end() { return dados + tamanho; }
+    const T* begin() const { return dados; }
+    const T* end() const { return dados + tamanho; }
+
+    void reserve(size_t n) {
+        if (n > capacidade) realocar(n);
+    }
+
+    void push_back(const T& valor) {
+        if (tamanho == capacidade) realocar(capacidade ? 2 * capacidade : 16);
+        dados[tamanho++] = valor;
+    }
+
+    template <typename Iterador>
+    void insert(T* posicao, Iterador inicio, Iterador fim) {   // só no fim, como o PoolSequencias usa
+        (void)posicao;
+        size_t quantidade = fim - inicio;
+        if (tamanho + quantidade > capacidade) realocar(std::max(tamanho + quantidade, 2 * capacidade));
+        for (Iterador it = inicio; it != fim; ++it) dados[tamanho++] = *it;
+    }
+
+    void resize(size_t n, const T& valor = T()) {
+        reserve(n);
+        for (size_t i = tamanho; i < n; i++) dados[i] = valor;
+        tamanho = n;
+    }
+
+    void assign(size_t n, const T& valor) {
+        tamanho = 0;
+        resize(n, valor);
+    }
+
+    void clear() { tamanho = 0; }
+
+private:
+    T* dados = nullptr;
+    size_t tamanho = 0;
+    size_t capacidade = 0;
+    int descritor = -1;     // arquivo do segmento, se mapeado
+
+    void realocar(size_t novaCapacidade) {
+        OrcamentoMemoria& orcamento = orcamentoMemoria();
+        size_t bytesAntes = capacidade * sizeof(T), bytesDepois = novaCapacidade * sizeof(T);
+        if (mapeado()) {
+            crescerSegmento(bytesAntes, bytesDepois);
+        } else if (orcamento.limiteBytes > 0 &&
+                   orcamento.emMemoria.load(std::memory_order_relaxed) - bytesAntes + bytesDepois > orcamento.limiteBytes) {
+            moverParaSegmento(bytesAntes, bytesDepois);
+        } else {
+            T* novos = static_cast<T*>(std::realloc(dados, bytesDepois));
+            if (!novos) throw std::bad_alloc();
+            dados = novos;
+            orcamento.emMemoria += bytesDepois;
+            orcamento.emMemoria -= bytesAntes;
+        }
+        capacidade = novaCapacidade;
+    }
+
+    void moverParaSegmento(size_t bytesAntes, size_t bytesDepois) {
+        OrcamentoMemoria& orcamento = orcamentoMemoria();
+        std::string modelo = orcamento.diretorio + "/vrp-segmento-XXXXXX";
+        descritor = mkstemp(&modelo[0]);
+        if (descritor < 0) falhar("não foi possível criar o segmento em " + orcamento.diretorio);
+        unlink(modelo.c_str());
+        reservarNoDisco(0, bytesDepois, "não foi possível reservar o segmento");
+        void* mapa = mmap(nullptr, bytesDepois, PROT_READ | PROT_WRITE, MAP_SHARED, descritor, 0);
+        if (mapa == MAP_FAILED) falhar("não foi possível mapear o segmento");
+        if (tamanho > 0) std::memcpy(mapa, dados, tamanho * sizeof(T));
+        std::free(dados);
+        orcamento.emMemoria -= bytesAntes;
+        dados = static_cast<T*>(mapa);
+        orcamento.emDisco += bytesDepois;
+        orcamento.segmentos++;
+        contar(SEGMENTOS_EM_DISCO);
+    }
+
+    void crescerSegmento(size_t bytesAntes, size_t bytesDepois) {
+        reservarNoDisco(bytesAntes, bytesDepois - bytesAntes, "não foi possível aumentar o segmento");
+        void* mapa = mremap(dados, bytesAntes, bytesDepois, MREMAP_MAYMOVE);
+        if (mapa == MAP_FAILED) falhar("não foi possível remapear o segmento");
+        dados = static_cast<T*>(mapa);
+        orcamentoMemoria().emDisco += bytesDepois - bytesAntes;
+    }
+
+    // Aloca os blocos de [inicio, inicio + bytes) no arquivo do segmento (e o estende até lá)
+    void reservarNoDisco(size_t inicio, size_t bytes, const std::string& mensagem) {
+        int erro = posix_fallocate(descritor, inicio, bytes);
+        if (erro != 0) {
+            errno = erro;   // posix_fallocate devolve o erro em vez de usar errno
+            falhar(mensagem);
+        }
+    }
+
+    void liberar() {
+        OrcamentoMemoria& orcamento = orcamentoMemoria();
+        if (mapeado()) {
+            if (capacidade > 0) munmap(dados, capacidade * sizeof(T));
+            close(descritor);
+            orcamento.emDisco -= capacidade * sizeof(T);
+            orcamento.segmentos--;
+        } else {
+            std::free(dados);
+            orcamento.emMemoria -= capacidade * sizeof(T);
+        }
+        dados = nullptr;
+        tamanho = capacidade = 0;
+        descritor = -1;
+    }
+
+    void copiarDe(const VetorMapeavel& outro) {
+        reserve(outro.tamanho);
+        if (outro.tamanho > 0) std::memcpy(dados, outro.dados, outro.tamanho * sizeof(T));
+        tamanho = outro.tamanho;
+    }
+
+    void tomarDe(VetorMapeavel& outro) {
+        dados = outro.dados;
+        tamanho = outro.tamanho;
+        capacidade = outro.capacidade;
+        descritor = outro.descritor;
+        outro.dados = nullptr;
+        outro.tamanho = outro.capacidade = 0;
+        outro.descritor = -1;
+    }
+
+    // Sem espaço no diretório temporário não há como continuar: a mensagem diz o motivo (errno, e.g. ENOSPC do
+    // posix_fallocate) em vez do OOM ou do SIGBUS
+    [[noreturn]] static void falhar(const std::string& mensagem) {
+        std::perror(("Memória externa: " + mensagem).c_str());
+        std::exit(1);
+    }
+};
+
+#endif
@@ -0,0 +1,228 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <atomic>
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <memory>
+#include <sched.h>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#include "vrp.h"
+
+// Modo NUMA do openmp (--numa), para nós com mais de um soquete:
+// - Threads fixas: cada thread OpenMP fica numa CPU, com as threads espalhadas entre os nós NUMA (como
+//   proc_bind(spread)). Se OMP_PROC_BIND ou OMP_PLACES foram definidos, o runtime já fixa as threads e a
+//   distribuição dele é respeitada.
+// - Réplicas por nó: as estruturas lidas por todas as threads (matriz de distâncias, conjunto de rotas) são copiadas
+//   uma vez por nó, por uma thread desse nó; pela política de primeiro toque do Linux as páginas da cópia ficam na
+//   memória local do nó, e cada thread lê a réplica do nó em que está.
+// - Banda por nó: bytes lidos (estimados pelos elementos acessados, sem descontar o cache) e tempo de parede das
+//   threads de cada nó nas fases paralelas, na seção "numa" do --estatisticas.
+// A topologia vem de /sys/devices/system/node, restrita às CPUs permitidas ao processo; sem ela há um nó só.
+
+struct TopologiaNuma {
+    vector<int> idsNos;             // número do nó no sistema, por índice compacto
+    vector<vector<int>> cpusDoNo;
+    vector<int> noDaCpu;            // índice compacto do nó de cada CPU (-1 se a CPU não é usada)
+
+    int numNos() const { return cpusDoNo.size(); }
+};
+
+// CPUs de uma lista no formato do kernel, e.g. "0-3,8-11"
+inline vector<int> lerListaCpus(const string& texto) {
+    vector<int> cpus;
+    size_t pos = 0;
+    while (pos < texto.size()) {
+        size_t fim = texto.find(',', pos);
+        if (fim == string::npos) fim = texto.size();
+        string faixa = texto.substr(pos, fim - pos);
+        int inicio, ultimo;
+        if (sscanf(faixa.c_str(), "%d-%d", &inicio, &ultimo) == 2) {
+            for (int cpu = inicio; cpu <= ultimo; cpu++) cpus.push_back(cpu);
+        } else if (sscanf(faixa.c_str(), "%d", &inicio) == 1) {
+            cpus.push_back(inicio);
+        }
+        pos = fim + 1;
+    }
+    return cpus;
+}
+
+inline TopologiaNuma lerTopologiaNuma() {
+    cpu_set_t permitidas;
+    CPU_ZERO(&permitidas);
+    sched_getaffinity(0, sizeof(permitidas), &permitidas);
+
+    vector<int> ids;
+    if (DIR* diretorio = opendir("/sys/devices/system/node")) {
+        while (dirent* entrada = readdir(diretorio)) {
+            int id;
+            if (sscanf(entrada->d_name, "node%d", &id) == 1) ids.push_back(id);
+        }
+        closedir(diretorio);
+    }
+    sort(ids.begin(), ids.end());
+
+    TopologiaNuma topologia;
+    topologia.noDaCpu.assign(CPU_SETSIZE, -1);
+    auto acrescentarNo = [&](int id, const vector<int>& cpus) {
+        vector<int> usadas;
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &permitidas) && topologia.noDaCpu[cpu] < 0) usadas.push_back(cpu);
+        }
+        if (usadas.empty()) return;     // nó só de memória, ou fora da máscara do processo
+        for (int cpu : usadas) topologia.noDaCpu[cpu] = topologia.numNos();
+        topologia.idsNos.push_back(id);
+        topologia.cpusDoNo.push_back(usadas);
+    };
+    for (int id : ids) {
+        ifstream arquivo("/sys/devices/system/node/node" + to_string(id) + "/cpulist");
+        string lista;
+        if (getline(arquivo, lista)) acrescentarNo(id, lerListaCpus(lista));
+    }
+    if (topologia.numNos() == 0) {
+        vector<int> todas;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &permitidas)) todas.push_back(cpu);
+        }
+        acrescentarNo(0, todas);
+    }
+    return topologia;
+}
+
+// Índice compacto do nó em que a thread atual está rodando
+inline int noDaThreadAtual(const TopologiaNuma& topologia) {
+    int cpu = sched_getcpu();
+    if (cpu < 0 || cpu >= (int)topologia.noDaCpu.size() || topologia.noDaCpu[cpu] < 0) return 0;
+    return topologia.noDaCpu[cpu];
+}
+
+// Fixa cada thread da equipe OpenMP numa CPU, alternando os nós (thread t no nó t % numNos).
+// Retorna false sem mexer em nada quando o runtime já fixa as threads (OMP_PROC_BIND / OMP_PLACES).
+// O libgomp reaproveita as mesmas threads nas regiões paralelas seguintes com o mesmo número de threads.
+inline bool fixarThreadsNuma(const TopologiaNuma& topologia) {
+    if (omp_get_proc_bind() != omp_proc_bind_false) return false;
+    #pragma omp parallel
+    {
+        int id = omp_get_thread_num();
+        int no = id % topologia.numNos();
+        const vector<int>& cpus = topologia.cpusDoNo[no];
+        cpu_set_t conjunto;
+        CPU_ZERO(&conjunto);
+        CPU_SET(cpus[(id / topologia.numNos()) % cpus.size()], &conjunto);
+        sched_setaffinity(0, sizeof(conjunto), &conjunto);
+    }
+    return true;
+}
+
+// Bytes lidos pela thread atual na fase medida (só contados no modo NUMA com --estatisticas)
+inline bool& medirBandaNuma() {
+    static bool ativa = false;
+    return ativa;
+}
+
+inline long long& bytesLidosDaThread() {
+    thread_local long long bytes = 0;
+    return bytes;
+}
+
+inline void contarBytesLidos(long long bytes) {
+    if (medirBandaNuma()) bytesLidosDaThread() += bytes;
+}
+
+// Uma cópia de 'original' por nó NUMA que tem threads, feita (e tocada primeiro) por uma thread do próprio nó.
+// 'local()' devolve a réplica do nó da thread atual, ou o original se esse nó não tem réplica.
+template <typename T>
+class ReplicasNuma {
+public:
+    ReplicasNuma(const T& original, const TopologiaNuma& topologia)
+        : original(&original), topologia(&topologia), porNo(topologia.numNos()) {
+        FaseCronometrada fase("replicacao_numa");
+        #pragma omp parallel
+        {
+            int no = noDaThreadAtual(topologia);
+            bool minha = false;
+            #pragma omp critical(replicas_numa)
+            {
+                if (!porNo[no]) {
+                    porNo[no] = make_unique<T>();
+                    minha = true;
+                }
+            }
+            if (minha) *porNo[no] = original;   // a cópia aloca e escreve as páginas nesta thread
+        }
+    }
+
+    const T& local() const {
+        int no = noDaThreadAtual(*topologia);
+        return porNo[no] ? *porNo[no] : *original;
+    }
+
+private:
+    const T* original;
+    const TopologiaNuma* topologia;
+    vector<unique_ptr<T>> porNo;
+};
+
+// Banda de memória por nó numa fase paralela: cada thread registra, no fim do seu trecho, os bytes que leu e o
+// tempo que levou; a banda do nó é o total de bytes dividido pelo maior tempo entre as threads do nó
+class BandaNuma {
+public:
+    explicit BandaNuma(int numNos) : nos(numNos), bytes(new atomic<long long>[numNos]), ns(new atomic<long long>[numNos]),
+                                     threads(new atomic<int>[numNos]) {
+        for (int no = 0; no < numNos; no++) {
+            bytes[no] = 0;
+            ns[no] = 0;
+            threads[no] = 0;
+        }
+    }
+
+    void registrar(int no, long long bytesLidos, long long nsDecorridos) {
+        bytes[no] += bytesLidos;
+        threads[no] += 1;
+        long long atual = ns[no].load();
+        while (nsDecorridos > atual && !ns[no].compare_exchange_weak(atual, nsDecorridos)) {}
+    }
+
+    // [{"no": 0, "threads": 4, "bytes": ..., "ms": ..., "mb_por_s": ...}, ...]
+    string json(const TopologiaNuma& topologia) const {
+        string saida = "[";
+        char linha[256];
+        for (int no = 0; no < nos; no++) {
+            double ms = ns[no] / 1e6;
+            double mbPorS = ns[no] > 0 ? bytes[no] / 1e6 / (ns[no] / 1e9) : 0;
+            snprintf(linha, sizeof(linha), "%s{\"no\": %d, \"threads\": %d, \"bytes\": %lld, \"ms\": %.3f, \"mb_por_s\": %.1f}",
+                     no == 0 ? "" : ", ", topologia.idsNos[no], threads[no].load(), bytes[no].load(), ms, mbPorS);
+            saida += linha;
+        }
+        return saida + "]";
+    }
+
+private:
+    int nos;
+    unique_ptr<atomic<long long>[]> bytes;
+    unique_ptr<atomic<long long>[]> ns;
+    unique_ptr<atomic<int>[]> threads;
+};
+
+// Trecho de uma thread numa fase medida: registra na banda (se houver) os bytes lidos e o tempo do escopo
+struct TrechoBandaNuma {
+    BandaNuma* banda;
+    int no = 0;
+    long long inicio = 0;
+
+    TrechoBandaNuma(BandaNuma* banda, const TopologiaNuma* topologia) : banda(banda) {
+        if (!banda) return;
+        no = noDaThreadAtual(*topologia);
+        inicio = agoraNs();
+        bytesLidosDaThread() = 0;
+    }
+    ~TrechoBandaNuma() {
+        if (banda) banda->registrar(no, bytesLidosDaThread(), agoraNs() - inicio);
+    }
+};
+
+#endif
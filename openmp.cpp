@@ -8,167 +8,161 @@
 #include <omp.h>
 #include <numeric>  // Inclui a biblioteca necessária para usar iota
 
+#include "vrp.h"
+#include "numa.h"
+#include "arquivosolucao.h"
 
 using namespace std;
 using namespace std::chrono;
 
-// Le o arquivo de entrada e retorna um vetor com as demandas de cada vertice e atualiza o numero de vertices
-vector<int> LerDestinoDemanda(const string& nomeArquivo, int& numVertices) {
-    ifstream arquivo(nomeArquivo);
-    if (!arquivo.is_open()) {
-        cerr << "Erro ao abrir o arquivo " << nomeArquivo << endl;
-        exit(1);
-    }
-    
-    arquivo >> numVertices;
-
-    vector<int> grafo(numVertices, 0);
-    int destino, demanda;
-    for (int i = 1; i < numVertices; i++) {
-        arquivo >> destino >> demanda;
-        grafo[destino] = demanda;
-    }
-    arquivo.close();
-    return grafo;
+// Modo --numa (numa.h): threads fixas, réplicas por nó da matriz e do conjunto de rotas, e banda por nó das fases paralelas
+struct ContextoNuma {
+    TopologiaNuma topologia;
+    unique_ptr<ReplicasNuma<vector<vector<int>>>> locais;
+    unique_ptr<ReplicasNuma<vector<vector<int>>>> rotas;
+    unique_ptr<ReplicasNuma<MatrizPlana>> plana;
+    unique_ptr<BandaNuma> bandaEnumeracao;
+    unique_ptr<BandaNuma> bandaCusto;
+};
+
+// Bytes lidos ao avaliar um itinerário: os nós de cada rota e um arco da matriz por par de nós consecutivos
+inline long long bytesItinerario(const vector<int>& combinacao, const vector<vector<int>>& rotas) {
+    long long bytes = combinacao.size() * sizeof(int);
+    for (int indice : combinacao) bytes += (2 * rotas[indice].size() - 1) * sizeof(int) + sizeof(vector<int>);
+    return bytes;
 }
 
-// Le o arquivo de entrada e retorna um vetor com as rotas possiveis e atualiza o numero de vertices
-vector<vector<int>> LerRotasPossiveis(const string& nomeArquivo, int& numVertices) {
-    ifstream arquivo(nomeArquivo);
-    if (!arquivo.is_open()) {
-        cerr << "Erro ao abrir o arquivo " << nomeArquivo << endl;
-        exit(1);
-    }
-
-    arquivo >> numVertices;
-     
-    // ignora as proximas numVertices-1 linhas (sao as demandas dos vertices lidas anteriormente)
-    for (int i = 0; i < numVertices-1; i++) {
-        int x, y;
-        arquivo >> x >> y;
-    }
-
-    // le a quantidade de rotas possiveis
-    int numRotas;
-    arquivo >> numRotas;
-
-    // cria um grafo com numVertices vertices e inicializa com 0 e le as rotas
-    vector<vector<int>> grafo(numVertices, vector<int>(numVertices, 0));
-
-    int origem, destino, custo;
-    while (arquivo >> origem >> destino >> custo) {
-        grafo[origem][destino] = custo;     // GRAFO DIRECIONADO!
-    }
-    arquivo.close();
-    return grafo;
-}
-
-// Função para calcular o custo de uma rota
-int calcularCusto(const vector<int>& rota, const vector<vector<int>>& rotas) {
-    int custo = 0;
-    for (size_t i = 0; i < rota.size() - 1; ++i) {
-        int origem = rota[i];
-        int destino = rota[i + 1];
-        if (rotas[origem][destino] == 0) {
-            return -1;  // Indica rota inválida
-        }
-        custo += rotas[origem][destino];
-    }
-    return custo;
-}
-
-// Função para verificar se a capacidade do veículo é respeitada. A soma das demandas não pode ultrapassar a capacidade
-int verificaCapacidade(const vector<int>& rota, const vector<int>& demandas, int capacidadeVeiculo){
-    int carga_total = 0;
-    for (int index : rota){
-        carga_total += demandas[index];
-    }
-    if (carga_total > capacidadeVeiculo){
-        return 0;
-    }
-
-    return 1;
-}
-
-bool rotaJaExiste(const vector<int>& sub, const vector<vector<int>>& combinacoesValidas) {
-    // Verifica se 'sub' já existe em 'combinacoesValidas'
-    return find(combinacoesValidas.begin(), combinacoesValidas.end(), sub) != combinacoesValidas.end();
-}
-
-// Função para gerar todas as combinações possíveis de rotas válidas independente do custo
-void GerarTodasAsCombinacoesPossiveis(const vector<vector<int>>& rotas, int num_cidades, vector<vector<int>>& resultados, 
-                                      vector<int>& demandas, int capacidadeVeiculo) {
-    int n = rotas.size();
+// Função para gerar todas as combinações possíveis de rotas válidas independente do custo.
+// Cada thread enche um lote (avaliacaolote.h) por posição da fatia com PERMUTACOES_POR_LOTE das suas permutações e avalia
+// os lotes juntos sobre a matriz plana; as rotas viáveis são montadas numa única 'Rota' (RotaFixa<maxParadas> ou vector<int>,
+// rotafixa.h) reaproveitada e deduplicadas no PoolSequencias (poolrotas.h) da thread, sem trava. Os pools das threads são
+// unidos numa seção crítica por thread no fim, e só então copiados para 'resultados'.
+template <typename Rota>
+void GerarTodasAsCombinacoesPossiveis(const MatrizPlana& plana, int num_cidades, vector<vector<int>>& resultados,
+                                      int capacidadeVeiculo, LimitesExecucao& limites, const ContextoNuma* numa = nullptr) {
+    int n = plana.n;
     vector<int> indices(n);
     iota(indices.begin(), indices.end(), 0);
 
     vector<vector<int>> all_permutations;
+    FaseCronometrada faseGeracao("geracao_permutacoes");
     // Gera todas as permutações possíveis
     do {
         all_permutations.push_back(indices);
-    } while (next_permutation(indices.begin() + 1, indices.end()));  // Ignora permutar o depósito
-
+    } while (!limites.parar() && next_permutation(indices.begin() + 1, indices.end()));  // Ignora permutar o depósito
+    faseGeracao.encerrar();
+
+    FaseCronometrada faseAvaliacao("avaliacao_permutacoes");
+    // começa com as rotas das chamadas anteriores: a última fatia de uma permutação pode repetir uma rota mais curta
+    PoolSequencias aceitas;
+    for (const vector<int>& rota : resultados) aceitas.adicionar(rota);
+    uint32_t anteriores = aceitas.size();
     // Paraleliza a avaliação das permutações
-    #pragma omp parallel for schedule(dynamic)
-    for (size_t k = 0; k < all_permutations.size(); ++k) {
-        const vector<int>& perm = all_permutations[k];
+    #pragma omp parallel
+    {
+        const MatrizPlana& matriz = numa ? numa->plana->local() : plana;   // réplica do nó da thread no modo NUMA
+        Rota sub;
+        PoolSequencias aceitasThread;
+        vector<LoteRotas> lotes;
         for (int i = 0; i < n; i += num_cidades) {
-            int j = min(i + num_cidades, n);
-            vector<int> sub(perm.begin() + i, perm.begin() + j);
-            vector<int> rota_custo;
-            // Insere o depósito (assumindo ser o local 0) apenas no início da rota
-            sub.insert(sub.begin(), 0);
-            sub.push_back(0);
-
-            // Verifica se a rota é válida - rota deve existir, não deve ser repetida e a capacidade do veículo deve ser respeitada
-            if (calcularCusto(sub, rotas) != -1 && verificaCapacidade(sub, demandas, capacidadeVeiculo)) {
-                #pragma omp critical
-                {
-                    if (!rotaJaExiste(sub, resultados)) {
-                        resultados.push_back(sub);
-                    }
+            lotes.emplace_back(min(num_cidades, n - i) + 2, PERMUTACOES_POR_LOTE);
+        }
+
+        // Verifica as rotas acumuladas - rota deve existir, não deve ser repetida e a capacidade do veículo deve ser respeitada
+        auto esvaziarLotes = [&]() {
+            for (LoteRotas& lote : lotes) avaliarLote(matriz, lote, capacidadeVeiculo);
+            for (int p = 0; p < lotes[0].quantidade; p++) {
+                for (const LoteRotas& lote : lotes) {
+                    if (!lote.viaveis[p]) continue;
+                    sub.clear();
+                    for (int k = 0; k < lote.comprimento; k++) sub.push_back(lote.no(p, k));
+                    if (!aceitasThread.adicionarSeNova(sub)) contar(DUPLICATAS_REJEITADAS);
+                }
+            }
+            for (LoteRotas& lote : lotes) lote.limpar();
+        };
+
+        #pragma omp for schedule(dynamic)
+        for (size_t k = 0; k < all_permutations.size(); ++k) {
+            if (k > 0 && limites.parar()) continue;  // a primeira permutação sempre é avaliada
+            const vector<int>& perm = all_permutations[k];
+            contar(PERMUTACOES_VISITADAS);
+            for (size_t s = 0; s < lotes.size(); s++) {
+                // Insere o depósito (assumindo ser o local 0) no início e no fim da rota
+                LoteRotas& lote = lotes[s];
+                int i = s * num_cidades;
+                int* coluna = lote.nos.data() + lote.quantidade;
+                coluna[0] = 0;
+                for (int p = 1; p < lote.comprimento - 1; p++) {
+                    coluna[(size_t)p * lote.capacidade] = perm[i + p - 1];
+                }
+                coluna[(size_t)(lote.comprimento - 1) * lote.capacidade] = 0;
+                lote.quantidade++;
+            }
+            if (lotes[0].cheio()) esvaziarLotes();
+        }
+        esvaziarLotes();
+
+        long long espera = inicioEsperaSecaoCritica();
+        #pragma omp critical
+        {
+            entradaSecaoCritica();
+            for (uint32_t id = 0; id < aceitasThread.size(); id++) {
+                if (aceitas.adicionarSeNova(aceitasThread[id])) {
+                    contar(ROTAS_ACEITAS);
+                } else {
+                    contar(DUPLICATAS_REJEITADAS);
                 }
             }
+            fimSecaoCritica(espera);
         }
     }
+    for (uint32_t id = anteriores; id < aceitas.size(); id++) resultados.push_back(paraVetor(aceitas[id]));
+    faseAvaliacao.encerrar();
 
+    FaseCronometrada faseDeduplicacao("deduplicacao_rotas");
     // Remove duplicatas dos resultados finais
     sort(resultados.begin(), resultados.end());
     resultados.erase(unique(resultados.begin(), resultados.end()), resultados.end());
 }
 
-// Função para verificar se há sobreposição de nós em todas as rotas
-// Cada combinação de rotas deve ter todos os nós e cada nó deve ser visitado apenas uma vez
-bool checkAllNodesWithoutOverlap(const vector<vector<int>>& routes, int totalNodes) {
-    set<int> visitedNodes;
-    for (const auto& route : routes) {
-        for (int node : route) {
-            // Ignore the depot node (assumed to be 0) if necessary
-            if (node == 0) continue;
-            // Check if the node has already been visited
-            if (visitedNodes.find(node) != visitedNodes.end()) {
-                return false; // Node overlap found
-            }
-            visitedNodes.insert(node);
+// Gera todas as rotas viáveis com até maxParadas-2 clientes, com RotaFixa<maxParadas> quando há instanciação para esse maxParadas
+void gerarRotasPossiveis(const vector<vector<int>>& locais, vector<int>& demandas, int C, int maxParadas, vector<vector<int>>& rotas_possiveis,
+                         LimitesExecucao& limites, ContextoNuma* numa = nullptr) {
+    MatrizPlana plana(locais, demandas);
+    if (numa) numa->plana = make_unique<ReplicasNuma<MatrizPlana>>(plana, numa->topologia);
+    despacharMaxParadas(maxParadas, [&](auto paradas) {
+        constexpr int M = decltype(paradas)::value;
+        using Rota = conditional_t<M == 0, vector<int>, RotaFixa<M == 0 ? 1 : M>>;
+        for (int num_cidades = 1; num_cidades < maxParadas - 1; ++num_cidades) {  // Neste caso, "num_cidades" são quantos nós podem ter em uma rota
+            GerarTodasAsCombinacoesPossiveis<Rota>(plana, num_cidades, rotas_possiveis, C, limites, numa);  // Itera sob todas as possibilidades de rota e adiciona a rotas_possiveis
         }
-    }
-
-    // Check if all nodes are visited (ignoring the depot node if necessary)
-    return visitedNodes.size() == totalNodes - 1; // Subtract 1 if depot node is excluded
+    });
 }
 
 // Função recursiva para gerar todas as combinações de rotas
 void gerarCombinacoesRecursivo(const vector<vector<int>>& rotas, vector<int>& combinacaoAtual, vector<vector<int>>& todasCombinacoes, 
-                               int tamanho_itinerario, int numVertices, int inicio) {
+                               int tamanho_itinerario, int numVertices, int inicio, LimitesExecucao& limites) {
+    if (limites.parar()) return;
+    contar(COMBINACOES_VISITADAS);
+
     // Verifica se a combinação atual contém todas as rotas
     if (combinacaoAtual.size() == tamanho_itinerario) {
         vector<vector<int>> vetor_de_verdade;
         for (int local : combinacaoAtual) {
             vetor_de_verdade.push_back(rotas[local]);
         }
+        contarBytesLidos(bytesItinerario(combinacaoAtual, rotas));
         if (checkAllNodesWithoutOverlap(vetor_de_verdade, numVertices)) {
+            long long espera = inicioEsperaSecaoCritica();
             #pragma omp critical
-            todasCombinacoes.push_back(combinacaoAtual);
+            {
+                entradaSecaoCritica();
+                todasCombinacoes.push_back(combinacaoAtual);
+                fimSecaoCritica(espera);
+            }
+        } else {
+            contar(COMBINACOES_PODADAS);
         }
         return;
     }
@@ -176,31 +170,41 @@ void gerarCombinacoesRecursivo(const vector<vector<int>>& rotas, vector<int>& co
     // Tenta adicionar cada rota que ainda não foi usada
     for (size_t i = inicio; i < rotas.size(); ++i) {
         combinacaoAtual.push_back(i);
-        gerarCombinacoesRecursivo(rotas, combinacaoAtual, todasCombinacoes, tamanho_itinerario, numVertices, i + 1);
+        gerarCombinacoesRecursivo(rotas, combinacaoAtual, todasCombinacoes, tamanho_itinerario, numVertices, i + 1, limites);
         combinacaoAtual.pop_back();
     }
 }
 
 // Função principal para gerar todas as combinações de rotas
-vector<vector<int>> gerarTodasAsCombinacoesItinerario(const vector<vector<int>>& rotas, int numVertices) {
+vector<vector<int>> gerarTodasAsCombinacoesItinerario(const vector<vector<int>>& rotas, int numVertices, LimitesExecucao& limites,
+                                                      const ContextoNuma* numa = nullptr) {
     vector<vector<int>> todasCombinacoes;
     
     #pragma omp parallel
     {
         vector<vector<int>> todasCombinacoesLocal;
         vector<int> combinacaoAtual;
-
-        #pragma omp for schedule(dynamic)
-        for (int k = 1; k <= rotas.size(); ++k) {
-            gerarCombinacoesRecursivo(rotas, combinacaoAtual, todasCombinacoesLocal, k, numVertices, 0);
+        // no modo NUMA cada thread lê as réplicas do seu nó
+        const vector<vector<int>>& rotasLocais = numa ? numa->rotas->local() : rotas;
+        {
+            TrechoBandaNuma trecho(numa ? numa->bandaEnumeracao.get() : nullptr, numa ? &numa->topologia : nullptr);
+            #pragma omp for schedule(dynamic) nowait
+            for (int k = 1; k <= rotas.size(); ++k) {
+                RegiaoRastreada regiao("itinerarios_k", k);   // uma região por tamanho de itinerário, para ver o desequilíbrio
+                gerarCombinacoesRecursivo(rotasLocais, combinacaoAtual, todasCombinacoesLocal, k, numVertices, 0, limites);
+            }
         }
 
+        long long espera = inicioEsperaSecaoCritica();
         #pragma omp critical
         {
+            entradaSecaoCritica();
             todasCombinacoes.insert(todasCombinacoes.end(), todasCombinacoesLocal.begin(), todasCombinacoesLocal.end());
+            fimSecaoCritica(espera);
         }
     }
 
+    FaseCronometrada faseDeduplicacao("deduplicacao_itinerarios");
     // Remover duplicatas das combinações finais
     sort(todasCombinacoes.begin(), todasCombinacoes.end());
     todasCombinacoes.erase(unique(todasCombinacoes.begin(), todasCombinacoes.end()), todasCombinacoes.end());
@@ -208,40 +212,41 @@ vector<vector<int>> gerarTodasAsCombinacoesItinerario(const vector<vector<int>>&
     return todasCombinacoes;
 }
 
-// Função para calcular o custo total de uma combinação de rotas
-int calculaCustoTotal(const vector<int>& combinacao, const vector<vector<int>>& rotas_possiveis, const vector<vector<int>>& rotas) {
-    int custoTotal = 0;
-    for (const auto& indiceRota : combinacao) {
-        int custoRota = calcularCusto(rotas_possiveis[indiceRota], rotas);
-        if (custoRota == -1) return -1; // Se uma rota é inválida, toda a combinação é inválida
-        custoTotal += custoRota;
-    }
-    return custoTotal;
-}
-
 // Função para calcular o menor custo entre todas as combinações de rotas
-int calcula_menor_custo_itinerarios(const vector<vector<int>>& todasCombinacoes, const vector<vector<int>>& rotas_possiveis, const vector<vector<int>>& rotas) {
-    int menorCusto = numeric_limits<int>::max();
-    vector<int> menorCustoIndices;
-
-    #pragma omp parallel for
-    for (size_t i = 0; i < todasCombinacoes.size(); ++i) {
-        const auto& combinacao = todasCombinacoes[i];
-        int custoTotal = calculaCustoTotal(combinacao, rotas_possiveis, rotas);
-        if (custoTotal != -1 && custoTotal < menorCusto) {
-            #pragma omp critical
-            {
-                if (custoTotal < menorCusto) {
-                    menorCusto = custoTotal;
-                    menorCustoIndices = combinacao;
+int calcula_menor_custo_itinerarios(const vector<vector<int>>& todasCombinacoes, const vector<vector<int>>& rotas_possiveis, const vector<vector<int>>& rotas,
+                                    LimitesExecucao& limites, Incumbente& incumbente, const ContextoNuma* numa = nullptr) {
+    #pragma omp parallel
+    {
+        const vector<vector<int>>& rotasLocais = numa ? numa->rotas->local() : rotas_possiveis;
+        const vector<vector<int>>& matriz = numa ? numa->locais->local() : rotas;
+        TrechoBandaNuma trecho(numa ? numa->bandaCusto.get() : nullptr, numa ? &numa->topologia : nullptr);
+        // estático: no modo NUMA cada thread avalia os itinerários que ela mesma copiou (posicionarItinerarios)
+        #pragma omp for schedule(static) nowait
+        for (size_t i = 0; i < todasCombinacoes.size(); ++i) {
+            // com o limite atingido so continua enquanto nao houver nenhuma solucao para entregar
+            if (incumbente.existe() && limites.parar()) continue;
+            contar(ITINERARIOS_AVALIADOS);
+            const auto& combinacao = todasCombinacoes[i];
+            contarBytesLidos(bytesItinerario(combinacao, rotasLocais));
+            int custoTotal = calculaCustoTotal(combinacao, rotasLocais, matriz);
+            if (custoTotal != -1 && custoTotal < incumbente.custo) {
+                vector<vector<int>> rotasCombinacao;
+                for (int index : combinacao) {
+                    rotasCombinacao.push_back(rotasLocais[index]);
                 }
+                incumbente.oferecer(custoTotal, rotasCombinacao, limites);
             }
         }
     }
 
-    cout << menorCusto << endl;
-    for (int index : menorCustoIndices) {
-        for (int local : rotas_possiveis[index]) {
+    if (limites.esgotado) {
+        cout << "Limite de execução atingido, exibindo a melhor solução encontrada" << endl;
+    }
+    int menorCusto = incumbente.custo;
+    // com o limite atingido antes da primeira solução viável a incumbente fica vazia
+    cout << (incumbente.existe() ? to_string(menorCusto) : "Nenhuma solução encontrada") << endl;
+    for (const auto& rota : incumbente.rotas) {
+        for (int local : rota) {
             cout << local << " ";
         }
         cout << "| ";
@@ -250,39 +255,98 @@ int calcula_menor_custo_itinerarios(const vector<vector<int>>& todasCombinacoes,
     return menorCusto;
 }    
 
-int ResolverVRPComDemanda(vector<vector<int>> locais, vector<int> demandas, int C, int& numVertices){
+// Modo NUMA: copia cada itinerário na thread que vai avaliá-lo (mesma divisão estática do laço de custo), para que
+// as páginas fiquem no nó dessa thread
+void posicionarItinerarios(vector<vector<int>>& todasCombinacoes) {
+    FaseCronometrada fase("posicionamento_numa");
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < todasCombinacoes.size(); ++i) {
+        vector<int> copia(todasCombinacoes[i]);
+        todasCombinacoes[i].swap(copia);
+    }
+}
+
+int ResolverVRPComDemanda(vector<vector<int>> locais, vector<int> demandas, int C, int& numVertices, LimitesExecucao& limites,
+                          ContextoNuma* numa = nullptr, vector<vector<int>>* rotasSaida = nullptr){
     int maxParadas = 5;
     vector<vector<int>> rotas_possiveis;
+    Incumbente incumbente;
+    oferecerRotasIndividuais(locais, demandas, C, numVertices, limites, incumbente);
+    if (numa) numa->locais = make_unique<ReplicasNuma<vector<vector<int>>>>(locais, numa->topologia);
 
     // Gera todas as combinações possíveis de rotas de todos os tamanhos
-    for (int num_cidades = 1; num_cidades < maxParadas - 1; ++num_cidades) {  // Neste caso, "num_cidades" são quantos nós podem ter em uma rota
-        GerarTodasAsCombinacoesPossiveis(locais, num_cidades, rotas_possiveis, demandas, C);  // Itera sob todas as possibilidades de rota e adiciona a rotas_possiveis
-    }
+    FaseCronometrada faseRotas("geracao_rotas");
+    gerarRotasPossiveis(locais, demandas, C, maxParadas, rotas_possiveis, limites, numa);
+    faseRotas.encerrar();
+    if (numa) numa->rotas = make_unique<ReplicasNuma<vector<vector<int>>>>(rotas_possiveis, numa->topologia);
+
+    FaseCronometrada faseEnumeracao("enumeracao_itinerarios");
+    vector<vector<int>> todasCombinacoes = gerarTodasAsCombinacoesItinerario(rotas_possiveis, numVertices, limites, numa);
+    faseEnumeracao.encerrar();
+    if (numa) posicionarItinerarios(todasCombinacoes);
 
-    vector<vector<int>> todasCombinacoes = gerarTodasAsCombinacoesItinerario(rotas_possiveis, numVertices);
-    int menor = calcula_menor_custo_itinerarios(todasCombinacoes, rotas_possiveis, locais); 
+    FaseCronometrada faseCusto("custo_itinerarios");
+    int menor = calcula_menor_custo_itinerarios(todasCombinacoes, rotas_possiveis, locais, limites, incumbente, numa); 
 
+    if (rotasSaida) *rotasSaida = incumbente.rotas;
     return menor;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     int C = 15;
     int numVertices;
-    vector<int> demandas = LerDestinoDemanda("grafo.txt", numVertices);
-    vector<vector<int>> locais = LerRotasPossiveis("grafo.txt", numVertices);
+    LimitesExecucao limites;
+    LerLimites(argc, argv, limites);
+    LerInstrumentacao(argc, argv, "openmp");
+    unique_ptr<ContextoNuma> numa;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--numa") numa = make_unique<ContextoNuma>();
+    }
+    if (numa) {
+        numa->topologia = lerTopologiaNuma();
+        bool fixadasAqui = fixarThreadsNuma(numa->topologia);
+        medirBandaNuma() = instrumentacaoAtiva();
+        if (medirBandaNuma()) {
+            numa->bandaEnumeracao = make_unique<BandaNuma>(numa->topologia.numNos());
+            numa->bandaCusto = make_unique<BandaNuma>(numa->topologia.numNos());
+        }
+        cerr << "Modo NUMA: " << numa->topologia.numNos() << " nó(s), threads fixadas "
+             << (fixadasAqui ? "pelo programa" : "pelo runtime (OMP_PROC_BIND/OMP_PLACES)") << endl;
+    }
+
+    vector<int> demandas;
+    vector<vector<int>> locais;
+    {
+        FaseCronometrada fase("leitura");
+        demandas = LerDestinoDemanda("grafo.txt", numVertices);
+        locais = LerRotasPossiveis("grafo.txt", numVertices);
+    }
     
     // Capturar o tempo antes da execução
     auto start = high_resolution_clock::now();
     
-    int resultado = ResolverVRPComDemanda(locais, demandas, C, numVertices);
+    vector<vector<int>> rotas;
+    int resultado = ResolverVRPComDemanda(locais, demandas, C, numVertices, limites, numa.get(), &rotas);
     
     // Capturar o tempo após a execução
     auto end = high_resolution_clock::now();
     
     // Calcular a duração e exibir
     auto duration = duration_cast<milliseconds>(end - start).count();
-    cout << "\nMenor custo: " << resultado << "\n";
+    cout << "\nMenor custo: " << (resultado == INT_MAX ? "nenhuma solução encontrada" : to_string(resultado)) << "\n";
     cout << "Tempo de execução: " << duration << " ms" << endl;
+    gravarSolucaoSePedida(argc, argv, {"openmp", numVertices, C, 5, resultado, limites.esgotado}, rotas);
+
+    if (numa && medirBandaNuma()) {
+        string nos = "[";
+        for (int no = 0; no < numa->topologia.numNos(); no++) {
+            const vector<int>& cpus = numa->topologia.cpusDoNo[no];
+            nos += (no == 0 ? "" : ", ") + string("{\"no\": ") + to_string(numa->topologia.idsNos[no]) + ", \"cpus\": " + to_string(cpus.size()) + "}";
+        }
+        registrarSecaoInstrumentacao("numa", "{\"nos\": " + nos + "], \"banda\": {\"enumeracao_itinerarios\": " +
+                                     numa->bandaEnumeracao->json(numa->topologia) + ", \"custo_itinerarios\": " +
+                                     numa->bandaCusto->json(numa->topologia) + "}}");
+    }
 
     return 0;
 }
@@ -0,0 +1,377 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "buscaglobal.h"
+
+// Busca global em pipeline (buscaglobal --pipeline): as três etapas rodam ao mesmo tempo, em grupos de threads
+// separados, ligados por filas limitadas sem trava que levam lotes:
+//   geração das rotas  --lotes de rotas-->  montagem dos itinerários  --lotes de itinerários-->  custo
+// - Geração: cada thread percorre as permutações de uma unidade (num_cidades, primeiro cliente), avalia as fatias
+//   em lote (avaliacaolote.h) e envia as rotas viáveis ainda não vistas por ela.
+// - Montagem (uma thread, dona do conjunto de rotas): deduplica e, a cada rota nova r, enumera os itinerários cuja
+//   rota de maior id é r, por cobertura exata (sempre o menor cliente descoberto, só entre as rotas que o atendem).
+//   Cada itinerário é enumerado uma única vez, assim que a sua última rota chega, e o resultado é o mesmo da
+//   enumeração completa.
+// - Custo: calcula o custo de cada itinerário e oferece as melhorias à incumbente.
+// A incumbente que o custo encontra volta para as etapas anteriores: a geração descarta as rotas cujo custo mais
+// a saída mais barata de cada cliente fora delas já não melhora a incumbente, e a montagem poda com o mesmo limitante.
+// Fila cheia bloqueia quem produz (contador esperas_fila), então a memória em trânsito fica limitada pela
+// capacidade das filas.
+
+// Fila limitada de múltiplos produtores e consumidores, sem trava (anel com número de sequência por célula,
+// de D. Vyukov). Cada produtor avisa quando termina; 'retirar' devolve false quando a fila está vazia e todos
+// os produtores terminaram.
+template <typename T>
+class FilaLimitada {
+public:
+    // 'capacidade' é arredondada para potência de 2
+    FilaLimitada(size_t capacidade, int produtores) : produtoresAtivos(produtores) {
+        size_t tamanho = 2;
+        while (tamanho < capacidade) tamanho *= 2;
+        celulas.reset(new Celula[tamanho]);
+        mascara = tamanho - 1;
+        for (size_t i = 0; i < tamanho; i++) celulas[i].sequencia.store(i, std::memory_order_relaxed);
+    }
+
+    bool tentarInserir(T& valor) {
+        size_t pos = entrada.load(std::memory_order_relaxed);
+        for (;;) {
+            Celula& celula = celulas[pos & mascara];
+            size_t sequencia = celula.sequencia.load(std::memory_order_acquire);
+            intptr_t diferenca = (intptr_t)sequencia - (intptr_t)pos;
+            if (diferenca == 0) {
+                if (entrada.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    celula.valor = std::move(valor);
+                    celula.sequencia.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diferenca < 0) {
+                return false;   // cheia
+            } else {
+                pos = entrada.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tentarRetirar(T& valor) {
+        size_t pos = saida.load(std::memory_order_relaxed);
+        for (;;) {
+            Celula& celula = celulas[pos & mascara];
+            size_t sequencia = celula.sequencia.load(std::memory_order_acquire);
+            intptr_t diferenca = (intptr_t)sequencia - (intptr_t)(pos + 1);
+            if (diferenca == 0) {
+                if (saida.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    valor = std::move(celula.valor);
+                    celula.sequencia.store(pos + mascara + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diferenca < 0) {
+                return false;   // vazia
+            } else {
+                pos = saida.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Insere esperando enquanto a fila estiver cheia (contrapressão sobre o produtor)
+    void inserir(T valor) {
+        if (tentarInserir(valor)) return;
+        long long espera = rastreamentoAtivo() ? relogioRastreamentoNs() : 0;
+        do {
+            contar(ESPERAS_FILA);
+            std::this_thread::yield();
+        } while (!tentarInserir(valor));
+        if (rastreamentoAtivo()) registrarEvento("espera_fila_cheia", espera, relogioRastreamentoNs());
+    }
+
+    // Retira esperando enquanto a fila estiver vazia; false quando não há mais nada a retirar
+    bool retirar(T& valor) {
+        while (!tentarRetirar(valor)) {
+            if (produtoresAtivos.load(std::memory_order_acquire) == 0) return tentarRetirar(valor);
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    void produtorTerminou() { produtoresAtivos.fetch_sub(1, std::memory_order_release); }
+
+private:
+    struct Celula {
+        std::atomic<size_t> sequencia;
+        T valor;
+    };
+    std::unique_ptr<Celula[]> celulas;
+    size_t mascara;
+    alignas(64) std::atomic<size_t> entrada{0};
+    alignas(64) std::atomic<size_t> saida{0};
+    alignas(64) std::atomic<int> produtoresAtivos;
+};
+
+struct ConfigPipeline {
+    int threadsGeracao = 0;         // 0: metade das threads que sobram além da montagem
+    int threadsCusto = 0;           // 0: as demais
+    int rotasPorLote = 256;
+    int itinerariosPorLote = 256;
+    int capacidadeFila = 64;        // lotes em trânsito por fila
+};
+
+// Estado compartilhado pelas três etapas
+struct EstadoPipeline {
+    const vector<vector<int>>& locais;
+    const vector<int>& demandas;
+    int C;
+    int numVertices;
+    const ConfigPipeline& config;
+    LimitesExecucao& limites;
+    Incumbente& incumbente;
+    long long limitanteGlobal;
+
+    vector<long long> menorSaida;   // arco de saída mais barato de cada cliente (prepararPoda)
+    long long totalMenorSaida = 0;  // soma de menorSaida de todos os clientes
+    std::atomic<int> proximaUnidade{0};
+
+    FilaLimitada<PoolSequencias> rotasGeradas;
+    FilaLimitada<PoolSequencias> itinerarios;
+
+    EstadoPipeline(const vector<vector<int>>& locais, const vector<int>& demandas, int C, int numVertices, const ConfigPipeline& config,
+                   int threadsGeracao, LimitesExecucao& limites, Incumbente& incumbente, long long limitanteGlobal)
+        : locais(locais), demandas(demandas), C(C), numVertices(numVertices), config(config), limites(limites),
+          incumbente(incumbente), limitanteGlobal(limitanteGlobal),
+          rotasGeradas(config.capacidadeFila, threadsGeracao), itinerarios(config.capacidadeFila, 1) {}
+
+    // A incumbente já alcançou o limitante global ou um limite de execução foi atingido
+    bool encerrar(long long passos = 1) { return incumbente.custo <= limitanteGlobal || limites.parar(passos); }
+};
+
+// Etapa de geração: unidades (num_cidades, primeiro cliente da permutação) distribuídas entre as threads
+inline void etapaGeracao(EstadoPipeline& estado, int maxParadas) {
+    RegiaoRastreada regiao("estagio_geracao");
+    const int n = estado.locais.size();
+    const int clientes = n - 1;
+    const int unidades = clientes > 0 ? (maxParadas - 2) * clientes : 0;
+    MatrizPlana matriz(estado.locais, estado.demandas);
+    PoolSequencias vistas;      // rotas já enviadas por esta thread
+    PoolSequencias lote;
+    vector<int> sub;
+    vector<int> indices(n);
+
+    for (int unidade; !estado.encerrar() && (unidade = estado.proximaUnidade.fetch_add(1)) < unidades;) {
+        int num_cidades = unidade / clientes + 1;
+        int primeiro = unidade % clientes + 1;
+        RegiaoRastreada regiaoUnidade("unidade_geracao", unidade);
+        // permutações com 'primeiro' na posição 1: as demais posições começam em ordem crescente
+        indices[0] = 0;
+        indices[1] = primeiro;
+        for (int i = 1, k = 2; i < n; i++) {
+            if (i != primeiro) indices[k++] = i;
+        }
+        vector<LoteRotas> lotes;
+        for (int i = 0; i < n; i += num_cidades) {
+            lotes.emplace_back(min(num_cidades, n - i) + 2, PERMUTACOES_POR_LOTE);
+        }
+
+        auto esvaziarLotes = [&]() {
+            for (LoteRotas& loteRotas : lotes) avaliarLote(matriz, loteRotas, estado.C);
+            for (int p = 0; p < lotes[0].quantidade; p++) {
+                for (const LoteRotas& loteRotas : lotes) {
+                    if (!loteRotas.viaveis[p]) continue;
+                    // limitante de qualquer itinerário com esta rota: o custo dela e a saída mais barata de cada outro cliente
+                    long long limitante = loteRotas.custos[p] + estado.totalMenorSaida;
+                    sub.clear();
+                    for (int k = 0; k < loteRotas.comprimento; k++) {
+                        int no = loteRotas.no(p, k);
+                        sub.push_back(no);
+                        if (no != 0) limitante -= estado.menorSaida[no];
+                    }
+                    if (limitante >= estado.incumbente.custo) {
+                        contar(ROTAS_PODADAS);
+                        continue;
+                    }
+                    if (vistas.adicionarSeNova(sub)) lote.adicionar(sub);
+                    else contar(DUPLICATAS_REJEITADAS);
+                }
+            }
+            for (LoteRotas& loteRotas : lotes) loteRotas.limpar();
+            if ((int)lote.size() >= estado.config.rotasPorLote) {
+                estado.rotasGeradas.inserir(std::move(lote));
+                lote = PoolSequencias();
+            }
+        };
+
+        do {
+            contar(PERMUTACOES_VISITADAS);
+            for (size_t s = 0; s < lotes.size(); s++) {
+                LoteRotas& loteRotas = lotes[s];
+                int i = s * num_cidades;
+                int* coluna = loteRotas.nos.data() + loteRotas.quantidade;
+                coluna[0] = 0;
+                for (int k = 1; k < loteRotas.comprimento - 1; k++) {
+                    coluna[(size_t)k * loteRotas.capacidade] = indices[i + k - 1];
+                }
+                coluna[(size_t)(loteRotas.comprimento - 1) * loteRotas.capacidade] = 0;
+                loteRotas.quantidade++;
+            }
+            if (lotes[0].cheio()) {
+                esvaziarLotes();
+                if (estado.encerrar(PERMUTACOES_POR_LOTE)) break;
+            }
+        } while (next_permutation(indices.begin() + 2, indices.end()));
+        esvaziarLotes();
+    }
+    if (!lote.empty()) estado.rotasGeradas.inserir(std::move(lote));
+    estado.rotasGeradas.produtorTerminou();
+}
+
+// Estado da montagem: o conjunto de rotas recebidas, as rotas que atendem cada cliente (em ordem de id) e a poda
+struct AreaMontagem {
+    PoolSequencias rotas;
+    vector<vector<uint32_t>> rotasDoCliente;
+    AreaEnumeracao area;
+    vector<int> caminho;            // itinerário como um único passeio: 0 a b 0 c 0
+    PoolSequencias lote;
+};
+
+// Itinerários que completam a escolha atual só com rotas de id menor que 'ultima'
+inline void montarItinerarios(EstadoPipeline& estado, AreaMontagem& montagem, uint32_t ultima) {
+    AreaEnumeracao& area = montagem.area;
+    if (estado.encerrar()) return;
+    contar(COMBINACOES_VISITADAS);
+
+    int descoberto = 1;
+    while (descoberto < estado.numVertices && area.usos[descoberto] > 0) descoberto++;
+    if (descoberto == estado.numVertices) {
+        montagem.caminho.assign(1, 0);
+        for (int id : area.combinacaoAtual) {
+            VisaoSequencia rota = montagem.rotas[id];
+            montagem.caminho.insert(montagem.caminho.end(), rota.begin() + 1, rota.end());
+        }
+        montagem.lote.adicionar(montagem.caminho);
+        if ((int)montagem.lote.size() >= estado.config.itinerariosPorLote) {
+            estado.itinerarios.inserir(std::move(montagem.lote));
+            montagem.lote = PoolSequencias();
+        }
+        return;
+    }
+
+    // a rota que cobre o menor cliente descoberto é única no itinerário: cada cobertura aparece uma só vez
+    for (uint32_t id : montagem.rotasDoCliente[descoberto]) {
+        if (id >= ultima) break;
+        escolherRota(area, montagem.rotas, id);
+        if (area.sobreposicoes == 0 && area.custoParcial + area.faltaCobrir < estado.incumbente.custo) {
+            montarItinerarios(estado, montagem, ultima);
+        } else {
+            contar(COMBINACOES_PODADAS);
+        }
+        desfazerRota(area, montagem.rotas, id);
+    }
+}
+
+inline void etapaMontagem(EstadoPipeline& estado) {
+    RegiaoRastreada regiao("estagio_montagem");
+    AreaMontagem montagem;
+    AreaEnumeracao& area = montagem.area;
+    prepararPoda(area, montagem.rotas, estado.locais, estado.numVertices, estado.limitanteGlobal);
+    montagem.rotasDoCliente.resize(estado.numVertices);
+
+    PoolSequencias recebidas;
+    while (estado.rotasGeradas.retirar(recebidas)) {
+        for (uint32_t i = 0; i < recebidas.size(); i++) {
+            // depois de um limite só esvazia a fila, para que a geração não fique bloqueada
+            if (estado.encerrar()) break;
+            if (!montagem.rotas.adicionarSeNova(recebidas[i])) {
+                contar(DUPLICATAS_REJEITADAS);
+                continue;
+            }
+            contar(ROTAS_ACEITAS);
+            uint32_t id = montagem.rotas.size() - 1;
+            area.custosRotas.push_back(max(0, calcularCusto(montagem.rotas[id], estado.locais)));
+            for (int no : montagem.rotas[id]) {
+                if (no != 0) montagem.rotasDoCliente[no].push_back(id);
+            }
+            escolherRota(area, montagem.rotas, id);
+            if (area.sobreposicoes == 0 && area.custoParcial + area.faltaCobrir < estado.incumbente.custo) {
+                montarItinerarios(estado, montagem, id);
+            } else {
+                contar(COMBINACOES_PODADAS);
+            }
+            desfazerRota(area, montagem.rotas, id);
+        }
+    }
+    if (!montagem.lote.empty()) estado.itinerarios.inserir(std::move(montagem.lote));
+    estado.itinerarios.produtorTerminou();
+}
+
+inline void etapaCusto(EstadoPipeline& estado) {
+    RegiaoRastreada regiao("estagio_custo");
+    PoolSequencias lote;
+    while (estado.itinerarios.retirar(lote)) {
+        // com o limite atingido so continua enquanto nao houver nenhuma solucao para entregar
+        if (estado.incumbente.existe() && estado.limites.parar()) continue;
+        for (uint32_t id = 0; id < lote.size(); id++) {
+            VisaoSequencia caminho = lote[id];
+            contar(ITINERARIOS_AVALIADOS);
+            int custo = calcularCusto(caminho, estado.locais);
+            if (custo == -1 || custo >= estado.incumbente.custo) continue;
+            vector<vector<int>> itinerario;
+            for (size_t k = 1; k < caminho.size(); k++) {
+                if (caminho[k - 1] == 0) itinerario.push_back({0});
+                itinerario.back().push_back(caminho[k]);
+            }
+            estado.incumbente.oferecer(custo, itinerario, estado.limites);
+        }
+    }
+}
+
+// Busca global com as etapas em pipeline; mesmo resultado (custo ótimo) que buscaGlobal
+inline int buscaGlobalPipeline(const vector<vector<int>>& locais, const vector<int>& demandas, int C, int numVertices, int maxParadas,
+                               LimitesExecucao& limites, Incumbente& incumbente, const ConfigPipeline& config) {
+    oferecerRotasIndividuais(locais, demandas, C, numVertices, limites, incumbente);
+    Limitante limitante = calcularLimitante(locais, demandas, C, maxParadas - 2);
+
+    int disponiveis = max(3u, thread::hardware_concurrency());
+    int threadsGeracao = config.threadsGeracao > 0 ? config.threadsGeracao : max(1, (disponiveis - 1) / 2);
+    int threadsCusto = config.threadsCusto > 0 ? config.threadsCusto : max(1, disponiveis - 1 - threadsGeracao);
+
+    FaseCronometrada fase("pipeline");
+    EstadoPipeline estado(locais, demandas, C, numVertices, config, threadsGeracao, limites, incumbente, limitante.valor);
+    PoolSequencias vazio;
+    AreaEnumeracao saidas;
+    prepararPoda(saidas, vazio, locais, numVertices, limitante.valor);
+    estado.menorSaida = saidas.menorSaida;
+    estado.totalMenorSaida = saidas.faltaCobrir;
+
+    vector<thread> threads;
+    for (int t = 0; t < threadsGeracao; t++) threads.emplace_back(etapaGeracao, ref(estado), maxParadas);
+    threads.emplace_back(etapaMontagem, ref(estado));
+    for (int t = 0; t < threadsCusto; t++) threads.emplace_back(etapaCusto, ref(estado));
+    for (thread& t : threads) t.join();
+    return incumbente.custo;
+}
+
+inline int ResolverVRPPipeline(const vector<vector<int>>& locais, const vector<int>& demandas, int C, int numVertices, LimitesExecucao& limites,
+                               const ConfigPipeline& config, vector<vector<int>>* rotasSaida = nullptr) {
+    int maxParadas = 5;
+    Incumbente incumbente;
+    int menorCusto = buscaGlobalPipeline(locais, demandas, C, numVertices, maxParadas, limites, incumbente, config);
+
+    if (limites.esgotado) {
+        cout << "Limite de execução atingido, exibindo a melhor solução encontrada" << endl;
+    }
+    // com o limite atingido antes da primeira solução viável a incumbente fica vazia
+    cout << (incumbente.existe() ? to_string(menorCusto) : "Nenhuma solução encontrada") << endl;
+    for (const auto& rota : incumbente.rotas) {
+        for (int local : rota) {
+            cout << local << " ";
+        }
+        cout << "| ";
+    }
+
+    if (rotasSaida) *rotasSaida = incumbente.rotas;
+    return menorCusto;
+}
+
+#endif
@@ -0,0 +1,98 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+
+#include "polimento.h"
+#include "matriz.h"
+#include "limitantes.h"
+#include "arquivosolucao.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Polimento exato de uma solução do Clarke e Wright ou da inserção mais próxima (polimento.h): vizinhanças de
+// rotas próximas resolvidas pela busca global em paralelo. Com --inicial parte de um arquivo de --solucao de
+// qualquer programa, com a capacidade e o máximo de paradas dele.
+//   ./polimento [--resolvedor clarke|greedy] [--inicial solucao.txt] [--clientes-por-grupo 8] [--rotas-por-grupo 3]
+//               [--vizinhos 8] [--passadas 5] [--max-paradas 5] [--solucao arquivo]
+int main(int argc, char* argv[]) {
+    int numVertices;
+    LimitesExecucao limites;
+    LerLimites(argc, argv, limites);
+    LerInstrumentacao(argc, argv, "polimento");
+    ConfigPolimento config;
+    int capacidade = 15; // Capacidade do veículo
+    int maxParadas = 5;
+    string arquivoInicial;
+    for (int i = 1; i + 1 < argc; i++) {
+        string opcao = argv[i];
+        if (opcao == "--resolvedor") config.resolvedor = argv[++i];
+        else if (opcao == "--inicial") arquivoInicial = argv[++i];
+        else if (opcao == "--clientes-por-grupo") config.clientesPorGrupo = max(2, atoi(argv[++i]));
+        else if (opcao == "--rotas-por-grupo") config.rotasPorGrupo = max(2, atoi(argv[++i]));
+        else if (opcao == "--vizinhos") config.vizinhosPorRota = max(1, atoi(argv[++i]));
+        else if (opcao == "--passadas") config.passadas = atoi(argv[++i]);
+        else if (opcao == "--max-paradas") maxParadas = atoi(argv[++i]);
+    }
+    if (config.resolvedor != "clarke" && config.resolvedor != "greedy") {
+        cerr << "Resolvedor desconhecido: " << config.resolvedor << " (use clarke ou greedy)" << endl;
+        return 1;
+    }
+    // como nos programas isolados: o Clarke e Wright limita as paradas por rota, a inserção mais próxima não
+    int maxClientes = config.resolvedor == "clarke" ? maxParadas - 2 : 0;
+
+    vector<int> demandas;
+    vector<vector<int>> distancias;
+    unique_ptr<MatrizCoordenadas> coordenadas;
+    vector<vector<int>> rotasIniciais;
+    {
+        FaseCronometrada fase("leitura");
+        if (arquivoCoordenadas("grafo.txt")) {
+            string erro = LerInstanciaCoordenadas("grafo.txt", numVertices, demandas, coordenadas);
+            if (!erro.empty()) {
+                cerr << erro << endl;
+                return 1;
+            }
+        } else {
+            demandas = LerDestinoDemanda("grafo.txt", numVertices);
+            distancias = LerRotasPossiveis("grafo.txt", numVertices);
+        }
+
+        if (!arquivoInicial.empty()) {
+            SolucaoLida inicial;
+            string erro = LerSolucao(arquivoInicial, inicial);
+            if (erro.empty() && inicial.cabecalho.vertices != numVertices) {
+                erro = "A solução " + arquivoInicial + " é de uma instância com " + to_string(inicial.cabecalho.vertices) + " vértices";
+            }
+            if (!erro.empty()) {
+                cerr << erro << endl;
+                return 1;
+            }
+            capacidade = inicial.cabecalho.capacidade;
+            maxClientes = inicial.cabecalho.maxParadas > 0 ? inicial.cabecalho.maxParadas - 2 : 0;
+            for (size_t r = 0; r < inicial.numRotas(); r++) {
+                rotasIniciais.emplace_back(inicial.nos.begin() + inicial.inicios[r], inicial.nos.begin() + inicial.inicios[r + 1]);
+            }
+        }
+    }
+
+    vector<vector<int>> rotas;
+    auto start = high_resolution_clock::now();
+    // resolve, mede o tempo e calcula a distância até o ótimo (fora do tempo medido) sobre a mesma matriz
+    auto resolverEImprimir = [&](const auto& matriz, const MatrizCoordenadas* pontos) {
+        long long custo = ResolverVRPPolimento(matriz, demandas, capacidade, maxClientes, config, limites, move(rotasIniciais), pontos, &rotas);
+        auto end = high_resolution_clock::now();
+
+        auto duration = duration_cast<milliseconds>(end - start).count();
+        cout << "Tempo de execução: " << duration << " ms" << endl;
+        imprimirLimitante(custo, rotas, matriz, demandas, capacidade, maxClientes);
+        return custo;
+    };
+    // a densa é liberada assim que a compacta fica pronta
+    long long custo = coordenadas
+        ? resolverEImprimir(*coordenadas, coordenadas.get())
+        : comMatrizCompacta(move(distancias), [&](const auto& matriz) { return resolverEImprimir(matriz, nullptr); });
+    gravarSolucaoSePedida(argc, argv, {"polimento", numVertices, capacidade, maxClientes > 0 ? maxClientes + 2 : 0, custo, limites.esgotado}, rotas);
+
+    return 0;
+}
@@ -0,0 +1,304 @@
+#ifndef POLIMENTO_H
+#define POLIMENTO_H
+
+#include <iomanip>
+#include <unordered_set>
+
+#include "buscaglobal.h"
+#include "decomposicao.h"
+#include "gerador.h"
+
+// Polimento exato de uma solução heurística por vizinhanças de rotas.
+//
+// A busca global (buscaglobal.h) só é viável até uns 10 nós, que é justamente o tamanho do conjunto de clientes
+// atendido por duas ou três rotas vizinhas de uma solução do Clarke e Wright ou da inserção mais próxima. Cada
+// passada do polimento:
+// 1. Escolhe o centro de cada rota (o cliente de menor soma de distâncias aos demais da rota) e as rotas de centro
+//    mais próximo: todas as rotas numa matriz de distâncias, ou uma janela da ordem angular em torno do depósito
+//    nas instâncias com coordenadas.
+// 2. Monta vizinhanças disjuntas: cada rota livre, numa ordem sorteada por passada, junta as rotas vizinhas livres
+//    mais próximas enquanto o grupo couber em clientesPorGrupo e rotasPorGrupo.
+// 3. Resolve cada vizinhança como subinstância (depósito + clientes das rotas) com o conjunto de rotas e a
+//    enumeração dos itinerários da busca global, uma vizinhança por thread OpenMP. As rotas atuais entram como
+//    incumbente inicial, então a poda começa no custo delas e só uma solução estritamente melhor é aceita.
+// 4. Troca as rotas de cada vizinhança melhorada pelas novas.
+// Vizinhanças já resolvidas sem melhoria (mesmo conjunto de clientes) não são resolvidas de novo. O polimento
+// para numa passada sem melhoria, ao fim das passadas ou no limite de execução.
+
+struct ConfigPolimento {
+    string resolvedor = "clarke";           // solução inicial: clarke ou greedy
+    int clientesPorGrupo = 8;               // a busca global é exponencial nisso
+    int rotasPorGrupo = 3;
+    int vizinhosPorRota = 8;                // rotas candidatas a entrar na vizinhança de cada rota
+    int passadas = 5;
+};
+
+// Centro de cada rota: o cliente de menor soma de distâncias (distanciaAgrupamento) aos demais clientes da rota
+template <typename Matriz>
+inline vector<int> centrosDasRotas(const vector<vector<int>>& rotas, const Matriz& distancias) {
+    vector<int> centros(rotas.size(), 0);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (size_t r = 0; r < rotas.size(); r++) {
+        long long melhorSoma = LLONG_MAX;
+        for (size_t a = 1; a + 1 < rotas[r].size(); a++) {
+            long long soma = 0;
+            for (size_t b = 1; b + 1 < rotas[r].size(); b++) soma += distanciaAgrupamento(distancias, rotas[r][a], rotas[r][b]);
+            if (soma < melhorSoma) {
+                melhorSoma = soma;
+                centros[r] = rotas[r][a];
+            }
+        }
+    }
+    return centros;
+}
+
+// As numVizinhos rotas de centro mais próximo de cada rota. Com coordenadas os candidatos são as rotas a até
+// 4 * numVizinhos posições na ordem angular dos centros em torno do depósito; sem elas, todas as rotas.
+template <typename Matriz>
+inline vector<vector<int>> vizinhosDasRotas(const Matriz& distancias, const vector<int>& centros, int numVizinhos,
+                                            const MatrizCoordenadas* coordenadas) {
+    int numRotas = centros.size();
+    vector<int> ordemAngular, posicao(numRotas);
+    if (coordenadas) {
+        vector<pair<double, int>> angulos;
+        for (int r = 0; r < numRotas; r++) angulos.push_back({coordenadas->angulo(centros[r], 0), r});
+        sort(angulos.begin(), angulos.end());
+        for (int k = 0; k < numRotas; k++) {
+            ordemAngular.push_back(angulos[k].second);
+            posicao[angulos[k].second] = k;
+        }
+    }
+    const int janela = 4 * numVizinhos;
+
+    vector<vector<int>> vizinhos(numRotas);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int r = 0; r < numRotas; r++) {
+        vector<pair<long long, int>> candidatos;
+        auto considerar = [&](int s) {
+            if (s != r) candidatos.push_back({distanciaAgrupamento(distancias, centros[r], centros[s]), s});
+        };
+        if (coordenadas && numRotas > 2 * janela + 1) {
+            for (int d = -janela; d <= janela; d++) considerar(ordemAngular[(posicao[r] + d + numRotas) % numRotas]);
+        } else {
+            for (int s = 0; s < numRotas; s++) considerar(s);
+        }
+        int k = min<int>(numVizinhos, candidatos.size());
+        partial_sort(candidatos.begin(), candidatos.begin() + k, candidatos.end());
+        for (int c = 0; c < k; c++) {
+            if (candidatos[c].first < SEM_LIGACAO) vizinhos[r].push_back(candidatos[c].second);
+        }
+    }
+    return vizinhos;
+}
+
+// Vizinhanças disjuntas de uma passada (índices de rotas), só as de duas rotas ou mais
+inline vector<vector<int>> montarVizinhancas(const vector<vector<int>>& rotas, const vector<vector<int>>& vizinhos,
+                                             const ConfigPolimento& config, int passada) {
+    int numRotas = rotas.size();
+    vector<pair<uint64_t, int>> sorteio;
+    for (int r = 0; r < numRotas; r++) sorteio.push_back({misturarBits(((uint64_t)passada << 32) ^ r), r});
+    sort(sorteio.begin(), sorteio.end());
+
+    vector<bool> usada(numRotas, false);
+    vector<vector<int>> vizinhancas;
+    for (const auto& [chave, r] : sorteio) {
+        if (usada[r]) continue;
+        vector<int> grupo = {r};
+        int clientes = rotas[r].size() - 2;
+        for (int s : vizinhos[r]) {
+            if ((int)grupo.size() >= config.rotasPorGrupo) break;
+            if (usada[s] || clientes + (int)rotas[s].size() - 2 > config.clientesPorGrupo) continue;
+            grupo.push_back(s);
+            clientes += rotas[s].size() - 2;
+        }
+        if (grupo.size() < 2) continue;
+        for (int s : grupo) usada[s] = true;
+        vizinhancas.push_back(grupo);
+    }
+    return vizinhancas;
+}
+
+// Identifica o conjunto de clientes de uma vizinhança, para não resolver de novo as que não melhoraram
+inline uint64_t chaveVizinhanca(const vector<vector<int>>& rotas, const vector<int>& grupo) {
+    vector<int> clientes;
+    for (int r : grupo) clientes.insert(clientes.end(), rotas[r].begin() + 1, rotas[r].end() - 1);
+    sort(clientes.begin(), clientes.end());
+    uint64_t chave = clientes.size();
+    for (int cliente : clientes) chave = misturarBits(chave ^ (uint32_t)cliente);
+    return chave;
+}
+
+// Resolve a vizinhança com a busca global. Se achar custo menor que o das rotas atuais, deixa as rotas novas
+// (em índices globais) em 'novas' e retorna a redução; senão retorna 0.
+template <typename Matriz>
+inline long long resolverVizinhanca(const Matriz& distancias, const vector<int>& demandas, int capacidade, int maxClientes,
+                                    const vector<vector<int>>& atuais, vector<vector<int>>& novas, LimitesExecucao& limites) {
+    vector<int> nos = {0};
+    for (const auto& rota : atuais) nos.insert(nos.end(), rota.begin() + 1, rota.end() - 1);
+    int m = nos.size();
+    vector<vector<int>> sub(m, vector<int>(m));
+    vector<int> demandasSub(m);
+    for (int a = 0; a < m; a++) {
+        demandasSub[a] = a == 0 ? 0 : demandas[nos[a]];
+        for (int b = 0; b < m; b++) sub[a][b] = distancias[nos[a]][nos[b]];
+    }
+
+    // rotas atuais em índices locais: a incumbente inicial
+    vector<vector<int>> rotasLocais;
+    int custoAtual = 0;
+    for (const auto& rota : atuais) {
+        vector<int> local;
+        for (int no : rota) local.push_back(no == 0 ? 0 : find(nos.begin() + 1, nos.end(), no) - nos.begin());
+        int custo = calcularCusto(local, sub);
+        if (custo < 0) return 0;
+        custoAtual += custo;
+        rotasLocais.push_back(local);
+    }
+    Incumbente incumbente;
+    incumbente.silencioso = true;
+    incumbente.oferecer(custoAtual, rotasLocais, limites);
+
+    // nenhuma rota passa de tantos clientes quantos cabem no veículo começando pelas menores demandas; sem limite
+    // de clientes por rota é esse o tamanho máximo das rotas que a busca global gera
+    vector<int> ordenadas(demandasSub.begin() + 1, demandasSub.end());
+    sort(ordenadas.begin(), ordenadas.end());
+    int cabem = 0;
+    for (long long carga = 0; cabem < (int)ordenadas.size() && carga + ordenadas[cabem] <= capacidade; cabem++) carga += ordenadas[cabem];
+    if (maxClientes > 0) cabem = min(cabem, maxClientes);
+    int maxParadas = max(cabem, 1) + 2;
+    buscaGlobal(sub, demandasSub, capacidade, m, maxParadas, limites, incumbente);
+    if (incumbente.custo >= custoAtual) return 0;
+
+    novas = incumbente.rotas;
+    for (auto& rota : novas) {
+        for (int& no : rota) no = nos[no];
+    }
+    return custoAtual - incumbente.custo;
+}
+
+// Polimento de 'rotas' no lugar; retorna a redução total do custo. Imprime uma linha por passada.
+template <typename Matriz>
+inline long long polirSolucao(vector<vector<int>>& rotas, const Matriz& distancias, const vector<int>& demandas, int capacidade,
+                              int maxClientes, const ConfigPolimento& config, LimitesExecucao& limites,
+                              const MatrizCoordenadas* coordenadas = nullptr) {
+    FaseCronometrada fasePolimento("polimento");
+    long long custoTotal = 0;
+    for (const auto& rota : rotas) custoTotal += calcularCusto<long long>(rota, distancias);
+    long long reducao = 0;
+    unordered_set<uint64_t> semMelhoria;
+
+    for (int passada = 0; passada < config.passadas && !limites.tempoEsgotado(); passada++) {
+        vector<vector<int>> vizinhancas;
+        {
+            FaseCronometrada fase("vizinhancas");
+            vector<int> centros = centrosDasRotas(rotas, distancias);
+            vector<vector<int>> vizinhos = vizinhosDasRotas(distancias, centros, config.vizinhosPorRota, coordenadas);
+            for (auto& grupo : montarVizinhancas(rotas, vizinhos, config, passada)) {
+                if (!semMelhoria.count(chaveVizinhanca(rotas, grupo))) vizinhancas.push_back(move(grupo));
+            }
+        }
+        if (vizinhancas.empty()) break;
+
+        // as vizinhanças com mais clientes começam primeiro para equilibrar as threads
+        vector<int> clientes(vizinhancas.size(), 0);
+        for (size_t v = 0; v < vizinhancas.size(); v++) {
+            for (int r : vizinhancas[v]) clientes[v] += rotas[r].size() - 2;
+        }
+        vector<int> ordem(vizinhancas.size());
+        iota(ordem.begin(), ordem.end(), 0);
+        stable_sort(ordem.begin(), ordem.end(), [&](int a, int b) { return clientes[a] > clientes[b]; });
+
+        vector<vector<vector<int>>> novas(vizinhancas.size());
+        vector<long long> ganhos(vizinhancas.size(), 0);
+        int resolvidas = 0;
+        #pragma omp parallel for schedule(dynamic) reduction(+:resolvidas)
+        for (size_t k = 0; k < ordem.size(); k++) {
+            if (limites.tempoEsgotado()) continue;
+            int v = ordem[k];
+            vector<vector<int>> atuais;
+            for (int r : vizinhancas[v]) atuais.push_back(rotas[r]);
+            ganhos[v] = resolverVizinhanca(distancias, demandas, capacidade, maxClientes, atuais, novas[v], limites);
+            resolvidas++;
+            contar(VIZINHANCAS_RESOLVIDAS);
+        }
+
+        // troca as rotas das vizinhanças melhoradas; as outras ficam marcadas para não voltar
+        long long reducaoPassada = 0;
+        int melhoradas = 0;
+        vector<bool> substituida(rotas.size(), false);
+        vector<vector<int>> acrescentadas;
+        for (size_t v = 0; v < vizinhancas.size(); v++) {
+            if (ganhos[v] <= 0) {
+                if (!limites.esgotado) semMelhoria.insert(chaveVizinhanca(rotas, vizinhancas[v]));
+                continue;
+            }
+            melhoradas++;
+            reducaoPassada += ganhos[v];
+            for (int r : vizinhancas[v]) substituida[r] = true;
+            for (auto& rota : novas[v]) acrescentadas.push_back(move(rota));
+            contar(VIZINHANCAS_MELHORADAS);
+        }
+        if (melhoradas > 0) {
+            vector<vector<int>> polidas;
+            for (size_t r = 0; r < rotas.size(); r++) {
+                if (!substituida[r]) polidas.push_back(move(rotas[r]));
+            }
+            for (auto& rota : acrescentadas) polidas.push_back(move(rota));
+            rotas = move(polidas);
+        }
+
+        reducao += reducaoPassada;
+        cout << "Passada " << passada + 1 << ": " << resolvidas << " vizinhanças resolvidas, " << melhoradas
+             << " melhoradas, custo " << custoTotal - reducao << endl;
+        if (reducaoPassada > 0) reportarMelhoria(custoTotal - reducao, limites);
+        if (reducaoPassada == 0) break;
+    }
+    return reducao;
+}
+
+// Solução inicial pela heurística de config.resolvedor (ou 'rotasIniciais', se não vazias), polimento e impressão
+// no formato dos outros resolvedores. 'coordenadas' (opcional) restringe os candidatos a vizinhos à ordem angular.
+template <typename Matriz>
+inline long long ResolverVRPPolimento(const Matriz& distancias, const vector<int>& demandas, int capacidade, int maxClientes,
+                                      const ConfigPolimento& config, LimitesExecucao& limites, vector<vector<int>> rotasIniciais,
+                                      const MatrizCoordenadas* coordenadas = nullptr, vector<vector<int>>* rotasSaida = nullptr) {
+    vector<vector<int>> rotas = move(rotasIniciais);
+    string origem = "arquivo";
+    if (rotas.empty()) {
+        origem = config.resolvedor;
+        // as melhorias parciais da heurística não são custos da solução inicial: só ela é reportada
+        bool reportar = limites.reportar;
+        limites.reportar = false;
+        rotas = config.resolvedor == "greedy"
+            ? insercaoMaisProxima(distancias, demandas, capacidade, limites)
+            : clarkeWright(distancias, capacidade, demandas, maxClientes, limites);
+        reordenarRotas(rotas, distancias);
+        limites.reportar = reportar;
+    }
+    long long custoInicial = 0;
+    for (const auto& rota : rotas) custoInicial += calcularCusto<long long>(rota, distancias);
+    reportarMelhoria(custoInicial, limites);
+    cout << "Solução inicial (" << origem << "): " << rotas.size() << " rotas, custo " << custoInicial << endl;
+
+    long long reducao = polirSolucao(rotas, distancias, demandas, capacidade, maxClientes, config, limites, coordenadas);
+    long long custoTotal = custoInicial - reducao;
+
+    if (limites.esgotado) {
+        cout << "Limite de execução atingido, exibindo a melhor solução encontrada" << endl;
+    }
+    cout << "Polimento: custo " << custoInicial << " antes e " << custoTotal << " depois (" << fixed << setprecision(2)
+         << (custoInicial > 0 ? 100.0 * reducao / custoInicial : 0.0) << "% menor)" << defaultfloat << endl;
+    cout << "Rotas finais:" << endl;
+    for (const auto& rota : rotas) {
+        for (int cliente : rota) {
+            cout << cliente << " ";
+        }
+        cout << "(Custo: " << calcularCusto<long long>(rota, distancias) << ")\n";
+    }
+    cout << "Custo total: " << custoTotal << endl;
+
+    if (rotasSaida) *rotasSaida = rotas;
+    return custoTotal;
+}
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef POOLROTAS_H
+#define POOLROTAS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+#include "memoriaexterna.h"
+
+// Conjunto de sequências de inteiros (rotas ou itinerários) guardadas uma após a outra numa única arena, no estilo CSR:
+// 'nos' tem todas as sequências concatenadas e 'inicios[id]' marca onde começa a sequência 'id'. Os ids são de 32 bits
+// (o programa termina com erro se o conjunto passar de UINT32_MAX - 1 sequências); as posições em 'nos' são de 64 bits,
+// porque o total de nós passa de 2^32 bem antes do número de sequências.
+// Comparado a vector<vector<int>> não há um bloco de memória (e um cabeçalho de 24 bytes) por sequência, a varredura
+// em ordem é sequencial na memória e liberar tudo é só limpar dois vetores.
+// A deduplicação usa uma tabela hash de ids (endereçamento aberto) calculada sobre a forma compacta.
+// Os três vetores são VetorMapeavel (memoriaexterna.h): acima do orçamento de memória vão para segmentos em disco.
+
+// Uma sequência do conjunto, sem cópia; tem a mesma interface de leitura de vector<int>
+struct VisaoSequencia {
+    const int* inicio;
+    const int* fim;
+
+    size_t size() const { return fim - inicio; }
+    int operator[](size_t i) const { return inicio[i]; }
+    const int* begin() const { return inicio; }
+    const int* end() const { return fim; }
+};
+
+inline std::vector<int> paraVetor(const VisaoSequencia& sequencia) {
+    return std::vector<int>(sequencia.begin(), sequencia.end());
+}
+
+class PoolSequencias {
+public:
+    PoolSequencias() : inicios(1, 0) {}
+
+    uint32_t size() const { return inicios.size() - 1; }
+    bool empty() const { return size() == 0; }
+    size_t totalNos() const { return nos.size(); }
+    size_t bytes() const { return nos.capacity() * sizeof(int) + inicios.capacity() * sizeof(uint64_t) + tabela.capacity() * sizeof(uint32_t); }
+    bool emDisco() const { return nos.mapeado() || inicios.mapeado() || tabela.mapeado(); }
+
+    VisaoSequencia operator[](uint32_t id) const {
+        return {nos.data() + inicios[id], nos.data() + inicios[id + 1]};
+    }
+
+    void reservar(size_t sequencias, size_t totalNos) {
+        inicios.reserve(sequencias + 1);
+        nos.reserve(totalNos);
+    }
+
+    // Acrescenta a sequência sem verificar duplicatas e retorna o id
+    template <typename Sequencia>
+    uint32_t adicionar(const Sequencia& sequencia) {
+        verificarLimiteIds();
+        nos.insert(nos.end(), sequencia.begin(), sequencia.end());
+        inicios.push_back(nos.size());
+        if (!tabela.empty()) indexar(size() - 1);
+        return size() - 1;
+    }
+
+    // Acrescenta a sequência se ainda não existe; retorna true se foi acrescentada
+    template <typename Sequencia>
+    bool adicionarSeNova(const Sequencia& sequencia) {
+        if (tabela.empty()) reconstruirIndice(64);
+        uint64_t h = hashSequencia(sequencia.begin(), sequencia.end());
+        size_t mascara = tabela.size() - 1;
+        for (size_t pos = h & mascara; ; pos = (pos + 1) & mascara) {
+            uint32_t id = tabela[pos];
+            if (id == VAZIO) break;
+            if (igual((*this)[id], sequencia)) return false;
+        }
+        verificarLimiteIds();
+        nos.insert(nos.end(), sequencia.begin(), sequencia.end());
+        inicios.push_back(nos.size());
+        indexar(size() - 1);
+        return true;
+    }
+
+    // Libera todas as sequências de uma vez (a memória fica reservada para o próximo uso)
+    void limpar() {
+        nos.clear();
+        inicios.resize(1);
+        tabela.clear();
+        ocupados = 0;
+    }
+
+private:
+    static constexpr uint32_t VAZIO = UINT32_MAX;
+    VetorMapeavel<int> nos;
+    VetorMapeavel<uint64_t> inicios;
+    VetorMapeavel<uint32_t> tabela;   // ids, ou VAZIO; tamanho potência de 2 com ocupação até 1/2
+    size_t ocupados = 0;
+
+    // VAZIO marca posição livre na tabela, então o maior id válido é VAZIO - 1
+    void verificarLimiteIds() const {
+        if (size() >= VAZIO - 1) {
+            std::cerr << "Conjunto de sequências com mais de " << VAZIO - 1 << " elementos (ids de 32 bits)" << std::endl;
+            std::exit(1);
+        }
+    }
+
+    template <typename Iterador>
+    static uint64_t hashSequencia(Iterador inicio, Iterador fim) {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (Iterador it = inicio; it != fim; ++it) {
+            h = (h ^ (uint32_t)*it) * 0x100000001b3ULL;
+        }
+        return h ^ (h >> 29);
+    }
+
+    template <typename Sequencia>
+    static bool igual(const VisaoSequencia& a, const Sequencia& b) {
+        if (a.size() != (size_t)(b.end() - b.begin())) return false;
+        auto it = b.begin();
+        for (const int* p = a.begin(); p != a.end(); ++p, ++it) {
+            if (*p != *it) return false;
+        }
+        return true;
+    }
+
+    void indexar(uint32_t id) {
+        if (2 * (ocupados + 1) > tabela.size()) {
+            reconstruirIndice(tabela.size() * 2);
+            return;   // a reconstrução já indexou todas as sequências, inclusive 'id'
+        }
+        VisaoSequencia s = (*this)[id];
+        size_t mascara = tabela.size() - 1;
+        size_t pos = hashSequencia(s.begin(), s.end()) & mascara;
+        while (tabela[pos] != VAZIO) pos = (pos + 1) & mascara;
+        tabela[pos] = id;
+        ocupados++;
+    }
+
+    void reconstruirIndice(size_t capacidade) {
+        while (capacidade < 2 * (size_t)size() + 2) capacidade *= 2;
+        tabela.assign(capacidade, VAZIO);
+        ocupados = 0;
+        size_t mascara = capacidade - 1;
+        for (uint32_t id = 0; id < size(); id++) {
+            VisaoSequencia s = (*this)[id];
+            size_t pos = hashSequencia(s.begin(), s.end()) & mascara;
+            while (tabela[pos] != VAZIO) pos = (pos + 1) & mascara;
+            tabela[pos] = id;
+            ocupados++;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef RASTREAMENTO_H
+#define RASTREAMENTO_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Linha do tempo por thread e por rank MPI (--rastreamento <arquivo.json>), no formato de eventos do Chrome trace,
+// que o chrome://tracing e o Perfetto (ui.perfetto.dev) abrem diretamente.
+//
+// Cada thread grava os próprios eventos num anel de EVENTOS_POR_THREAD posições, sem trava: só a dona escreve
+// no anel, e a trava global é usada apenas duas vezes por thread, para obter o anel e para devolvê-lo quando a
+// thread termina. Um anel devolvido é reaproveitado pela próxima thread nova, com os eventos anteriores: processos
+// que criam uma thread por tarefa (o servidor.cpp cria uma por requisição) têm tantos anéis quanto threads
+// simultâneas, não um por thread que já existiu, e cada anel aparece no trace como uma faixa por onde passaram
+// threads sucessivas. Quando o anel enche, os eventos mais antigos são sobrescritos (a quantidade descartada vai
+// nos metadados da thread). Os anéis são juntados
+// num único arquivo no fim do programa; no MPI, o rank 0 junta os eventos de todos os ranks (MPI.cpp).
+//
+// Eventos: regiões (RegiaoRastreada e as fases de FaseCronometrada), espera e permanência nas seções críticas
+// (instrumentacao.h) e na trava da incumbente (limites.h), e as chamadas MPI.
+
+const size_t EVENTOS_POR_THREAD = 1 << 16;       // padrão; --eventos-por-thread muda
+
+struct EventoRastreamento {
+    const char* nome;           // literal: o anel guarda só o ponteiro
+    long long inicioNs;
+    long long duracaoNs;
+    long long valor;            // argumento do evento (e.g. k do laço), -1 se não houver
+};
+
+struct AnelRastreamento {
+    int tid;
+    std::vector<EventoRastreamento> eventos;
+    std::atomic<unsigned long long> escritos{0};
+
+    AnelRastreamento(int tid, size_t capacidade) : tid(tid), eventos(capacidade) {}
+
+    void registrar(const EventoRastreamento& evento) {
+        unsigned long long n = escritos.load(std::memory_order_relaxed);
+        eventos[n % eventos.size()] = evento;
+        escritos.store(n + 1, std::memory_order_release);
+    }
+};
+
+struct EstadoRastreamento {
+    bool ativo = false;
+    bool gravarNoFim = true;    // false no MPI, onde o rank 0 grava os eventos de todos
+    std::string arquivo;
+    std::string nomeProcesso;
+    int processo = 0;           // pid do trace: o rank no MPI
+    size_t eventosPorThread = EVENTOS_POR_THREAD;
+
+    std::mutex trava;
+    std::deque<AnelRastreamento> aneis;     // deque: os endereços não mudam ao registrar novas threads
+    std::vector<AnelRastreamento*> livres;  // anéis de threads que já terminaram
+};
+
+inline EstadoRastreamento& rastreamento() {
+    static EstadoRastreamento estado;
+    return estado;
+}
+
+inline bool rastreamentoAtivo() {
+    return rastreamento().ativo;
+}
+
+inline long long relogioRastreamentoNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Anel de uma thread; o destrutor (na saída da thread) devolve o anel para a lista de livres
+struct DonoAnelRastreamento {
+    AnelRastreamento* anel = nullptr;
+
+    ~DonoAnelRastreamento() {
+        if (!anel) return;
+        EstadoRastreamento& estado = rastreamento();
+        std::lock_guard<std::mutex> lock(estado.trava);
+        estado.livres.push_back(anel);
+    }
+};
+
+// Anel da thread atual, obtido no primeiro evento da thread: um livre, se houver, ou um novo
+inline AnelRastreamento& anelDaThread() {
+    thread_local DonoAnelRastreamento dono;
+    if (!dono.anel) {
+        EstadoRastreamento& estado = rastreamento();
+        std::lock_guard<std::mutex> lock(estado.trava);
+        if (!estado.livres.empty()) {
+            dono.anel = estado.livres.back();
+            estado.livres.pop_back();
+        } else {
+            estado.aneis.emplace_back((int)estado.aneis.size(), estado.eventosPorThread);
+            dono.anel = &estado.aneis.back();
+        }
+    }
+    return *dono.anel;
+}
+
+inline void registrarEvento(const char* nome, long long inicioNs, long long fimNs, long long valor = -1) {
+    if (!rastreamentoAtivo()) return;
+    anelDaThread().registrar({nome, inicioNs, fimNs - inicioNs, valor});
+}
+
+// Região de escopo na linha do tempo da thread
+struct RegiaoRastreada {
+    const char* nome;
+    long long valor;
+    long long inicio;
+
+    explicit RegiaoRastreada(const char* nome, long long valor = -1)
+        : nome(nome), valor(valor), inicio(rastreamentoAtivo() ? relogioRastreamentoNs() : 0) {}
+    ~RegiaoRastreada() {
+        if (rastreamentoAtivo()) registrarEvento(nome, inicio, relogioRastreamentoNs(), valor);
+    }
+};
+
+// Eventos deste processo em JSON (um objeto por linha, separados por vírgula), incluindo os nomes do processo e das threads
+inline std::string eventosRastreamentoJson() {
+    EstadoRastreamento& estado = rastreamento();
+    std::lock_guard<std::mutex> lock(estado.trava);
+    std::string json;
+    char linha[512];
+    auto acrescentar = [&](int tamanho) {
+        if (!json.empty()) json += ",\n";
+        json.append(linha, std::min<size_t>(tamanho, sizeof(linha) - 1));
+    };
+    acrescentar(std::snprintf(linha, sizeof(linha), "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"%s\"}}",
+                              estado.processo, estado.nomeProcesso.c_str()));
+    for (const AnelRastreamento& anel : estado.aneis) {
+        unsigned long long escritos = anel.escritos.load(std::memory_order_acquire);
+        unsigned long long capacidade = anel.eventos.size();
+        unsigned long long descartados = escritos > capacidade ? escritos - capacidade : 0;
+        acrescentar(std::snprintf(linha, sizeof(linha),
+                                  "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"name\": \"thread %d\", \"eventos_descartados\": %llu}}",
+                                  estado.processo, anel.tid, anel.tid, descartados));
+        for (unsigned long long n = descartados; n < escritos; n++) {
+            const EventoRastreamento& evento = anel.eventos[n % capacidade];
+            int tamanho = std::snprintf(linha, sizeof(linha), "{\"name\": \"%s\", \"cat\": \"vrp\", \"ph\": \"X\", \"pid\": %d, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+                                        evento.nome, estado.processo, anel.tid, evento.inicioNs / 1e3, evento.duracaoNs / 1e3);
+            if (evento.valor >= 0) {
+                tamanho += std::snprintf(linha + tamanho, sizeof(linha) - tamanho, ", \"args\": {\"valor\": %lld}", evento.valor);
+            }
+            tamanho += std::snprintf(linha + tamanho, sizeof(linha) - tamanho, "}");
+            acrescentar(tamanho);
+        }
+    }
+    return json;
+}
+
+// Grava o arquivo de trace com os eventos de um ou mais processos
+inline void gravarRastreamento(const std::vector<std::string>& partes) {
+    EstadoRastreamento& estado = rastreamento();
+    FILE* saida = std::fopen(estado.arquivo.c_str(), "w");
+    if (!saida) {
+        std::fprintf(stderr, "Erro ao abrir o arquivo %s\n", estado.arquivo.c_str());
+        return;
+    }
+    std::fprintf(saida, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    bool primeira = true;
+    for (const std::string& parte : partes) {
+        if (parte.empty()) continue;
+        std::fprintf(saida, "%s%s", primeira ? "" : ",\n", parte.c_str());
+        primeira = false;
+    }
+    std::fprintf(saida, "\n]}\n");
+    std::fclose(saida);
+}
+
+inline void escreverRastreamento() {
+    EstadoRastreamento& estado = rastreamento();
+    if (!estado.ativo || !estado.gravarNoFim) return;
+    gravarRastreamento({eventosRastreamentoJson()});
+}
+
+// Ativa o rastreamento se houver --rastreamento <arquivo> na linha de comando; o arquivo é gravado na saída do programa
+inline void LerRastreamento(int argc, char* argv[], const std::string& programa) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--eventos-por-thread") {
+            rastreamento().eventosPorThread = std::max(1LL, std::atoll(argv[i + 1]));
+        } else if (std::string(argv[i]) == "--rastreamento") {
+            EstadoRastreamento& estado = rastreamento();
+            estado.ativo = true;
+            estado.arquivo = argv[i + 1];
+            estado.nomeProcesso = programa;
+            std::atexit(escreverRastreamento);
+        }
+    }
+}
+
+#endif
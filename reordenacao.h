@@ -0,0 +1,115 @@
+#ifndef REORDENACAO_H
+#define REORDENACAO_H
+
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+#include "vrp.h"
+
+// Reordenação exata das paradas de cada rota (Held-Karp), aplicada às soluções das heurísticas.
+// O Clarke e Wright concatena as rotas na ordem das fusões e a inserção mais próxima anexa os clientes na ordem
+// do vizinho mais próximo; nenhuma das duas muda a ordem dentro da rota. Com os mesmos clientes a carga não muda,
+// então basta achar o caminho mais barato 0 -> clientes -> 0: programação dinâmica sobre subconjuntos,
+// O(2^k k^2) para k clientes, com arcos dirigidos e arcos inexistentes (peso 0) como proibidos.
+// Rotas com mais de MAX_CLIENTES_REORDENACAO clientes ficam como estão.
+
+const int MAX_CLIENTES_REORDENACAO = 12;
+
+// Memória da programação dinâmica, reaproveitada entre as rotas de uma thread
+struct AreaHeldKarp {
+    std::vector<int> arcos;         // (k+1) x (k+1): posição 0 é o depósito, 1..k os clientes da rota
+    std::vector<int> custo;         // custo[S * k + j]: menor caminho 0 -> S terminando no cliente j
+    std::vector<int8_t> anterior;
+};
+
+// Reordena as paradas da rota se houver ordem mais barata; retorna a redução do custo (0 se nenhuma)
+template <typename Matriz>
+inline int reordenarRota(vector<int>& rota, const Matriz& distancias, AreaHeldKarp& area) {
+    int k = (int)rota.size() - 2;
+    if (k < 2 || k > MAX_CLIENTES_REORDENACAO) return 0;
+    int custoAtual = calcularCusto(rota, distancias);
+    if (custoAtual == -1) return 0;
+
+    // arcos entre os nós da rota copiados antes: cada distancias[a][b] é um acesso avulso
+    const int m = k + 1;
+    area.arcos.resize(m * m);
+    for (int a = 0; a < m; a++) {
+        for (int b = 0; b < m; b++) area.arcos[a * m + b] = a == b ? 0 : distancias[rota[a]][rota[b]];
+    }
+    const int* arco = area.arcos.data();
+    const size_t subconjuntos = (size_t)1 << k;
+    area.custo.assign(subconjuntos * k, INT_MAX);
+    area.anterior.resize(subconjuntos * k);
+    int* custo = area.custo.data();
+    int8_t* anterior = area.anterior.data();
+
+    for (int j = 0; j < k; j++) {
+        if (arco[j + 1] != 0) custo[((size_t)1 << j) * k + j] = arco[j + 1];
+    }
+    for (size_t S = 1; S < subconjuntos; S++) {
+        for (int j = 0; j < k; j++) {
+            int base = custo[S * k + j];
+            if (base == INT_MAX) continue;
+            const int* saidas = arco + (j + 1) * m + 1;
+            for (int l = 0; l < k; l++) {
+                if ((S >> l) & 1 || saidas[l] == 0) continue;
+                size_t T = S | ((size_t)1 << l);
+                int novo = base + saidas[l];
+                if (novo < custo[T * k + l]) {
+                    custo[T * k + l] = novo;
+                    anterior[T * k + l] = j;
+                }
+            }
+        }
+    }
+
+    const size_t todos = subconjuntos - 1;
+    int melhor = INT_MAX, ultimo = -1;
+    for (int j = 0; j < k; j++) {
+        int volta = arco[(j + 1) * m];
+        if (custo[todos * k + j] == INT_MAX || volta == 0) continue;
+        if (custo[todos * k + j] + volta < melhor) {
+            melhor = custo[todos * k + j] + volta;
+            ultimo = j;
+        }
+    }
+    if (ultimo < 0 || melhor >= custoAtual) return 0;
+
+    vector<int> clientes(rota.begin() + 1, rota.end() - 1);
+    size_t S = todos;
+    for (int posicao = k, j = ultimo; posicao >= 1; posicao--) {
+        rota[posicao] = clientes[j];
+        int antes = anterior[S * k + j];
+        S &= ~((size_t)1 << j);
+        j = antes;
+    }
+    return custoAtual - melhor;
+}
+
+// Reordena todas as rotas, em paralelo, e retorna a redução total do custo
+template <typename Matriz>
+inline long long reordenarRotas(vector<vector<int>>& rotas, const Matriz& distancias) {
+    FaseCronometrada fase("reordenacao");
+    long long reducao = 0;
+    // clarke e greedy são compilados sem OpenMP: sem ele o laço roda sequencial, sem aviso de pragma desconhecido
+#ifdef _OPENMP
+    #pragma omp parallel reduction(+:reducao)
+#endif
+    {
+        AreaHeldKarp area;
+#ifdef _OPENMP
+        #pragma omp for schedule(dynamic, 16)
+#endif
+        for (size_t r = 0; r < rotas.size(); r++) {
+            int ganho = reordenarRota(rotas[r], distancias, area);
+            if (ganho > 0) {
+                contar(ROTAS_REORDENADAS);
+                reducao += ganho;
+            }
+        }
+    }
+    return reducao;
+}
+
+#endif
@@ -0,0 +1,110 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+
+#include "incremental.h"
+#include "resolvedores.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Resolve a instância, aplica um arquivo de alterações com a reotimização incremental e compara com
+// resolver a instância alterada do zero. Formato das alterações (uma por linha, # comenta):
+//   adicionar <cliente> <demanda>      (os arcos de um nó novo vêm em linhas 'arco')
+//   remover <cliente>
+//   demanda <cliente> <valor>
+//   arco <origem> <destino> <custo>    (custo 0 remove o arco)
+
+vector<Alteracao> LerAlteracoes(const string& nomeArquivo) {
+    ifstream arquivo(nomeArquivo);
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo " << nomeArquivo << endl;
+        exit(1);
+    }
+    vector<Alteracao> alteracoes;
+    string linha, tipo;
+    while (getline(arquivo, linha)) {
+        stringstream campos(linha);
+        if (!(campos >> tipo) || tipo[0] == '#') continue;
+        Alteracao alteracao;
+        if (tipo == "adicionar") { alteracao.tipo = ADICIONAR_CLIENTE; campos >> alteracao.cliente >> alteracao.valor; }
+        else if (tipo == "remover") { alteracao.tipo = REMOVER_CLIENTE; campos >> alteracao.cliente; }
+        else if (tipo == "demanda") { alteracao.tipo = ALTERAR_DEMANDA; campos >> alteracao.cliente >> alteracao.valor; }
+        else if (tipo == "arco") { alteracao.tipo = ALTERAR_ARCO; campos >> alteracao.cliente >> alteracao.destino >> alteracao.valor; }
+        else {
+            cerr << "Alteração desconhecida: " << linha << endl;
+            exit(1);
+        }
+        alteracoes.push_back(alteracao);
+    }
+    return alteracoes;
+}
+
+void imprimirRotas(const vector<vector<int>>& rotas) {
+    for (const auto& rota : rotas) {
+        for (int local : rota) cout << local << " ";
+        cout << "| ";
+    }
+    cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+    PedidoSolucao pedido;
+    string instancia = "grafo.txt", arquivoAlteracoes;
+    for (int i = 1; i < argc; i++) {
+        string opcao = argv[i];
+        if (opcao == "--resolvedor" && i + 1 < argc) pedido.resolvedor = argv[++i];
+        else if (opcao == "--capacidade" && i + 1 < argc) pedido.capacidade = atoi(argv[++i]);
+        else if (opcao == "--max-paradas" && i + 1 < argc) pedido.maxParadas = atoi(argv[++i]);
+        else if (opcao == "--instancia" && i + 1 < argc) instancia = argv[++i];
+        else arquivoAlteracoes = opcao;
+    }
+    if (arquivoAlteracoes.empty() || !resolvedorValido(pedido.resolvedor)) {
+        cerr << "uso: ./reotimiza <alteracoes.txt> [--instancia grafo.txt] [--resolvedor clarke|greedy|buscaglobal] [--capacidade 15] [--max-paradas 5]" << endl;
+        return 1;
+    }
+
+    int numVertices;
+    vector<int> demandas;
+    vector<vector<int>> distancias;
+    string erro = LerInstancia(instancia, numVertices, demandas, distancias);
+    if (!erro.empty()) {
+        cerr << erro << endl;
+        return 1;
+    }
+    vector<Alteracao> alteracoes = LerAlteracoes(arquivoAlteracoes);
+
+    Solucao inicial = resolver(pedido, demandas, distancias);
+    cout << "Solução inicial (" << pedido.resolvedor << "): custo " << inicial.custo << endl;
+
+    // a greedy não limita o número de paradas
+    int maxClientes = pedido.resolvedor == "greedy" ? 0 : pedido.maxParadas - 2;
+    auto inicio = high_resolution_clock::now();
+    ResultadoIncremental incremental = reotimizar(inicial.rotas, demandas, distancias, pedido.capacidade, maxClientes, alteracoes);
+    auto fim = high_resolution_clock::now();
+
+    cout << "Reotimização incremental: custo " << incremental.custo << ", " << incremental.rotasAfetadas << " rotas afetadas, "
+         << duration_cast<microseconds>(fim - inicio).count() << " us" << endl;
+    imprimirRotas(incremental.rotas);
+    if (!incremental.naoAtendidos.empty()) {
+        cout << "Clientes sem posição viável:";
+        for (int cliente : incremental.naoAtendidos) cout << " " << cliente;
+        cout << endl;
+    }
+
+    // referência: a instância já alterada resolvida do zero (clientes removidos ficam com demanda e arcos zerados)
+    for (const Alteracao& alteracao : alteracoes) {
+        if (alteracao.tipo != REMOVER_CLIENTE) continue;
+        demandas[alteracao.cliente] = 0;
+        for (size_t i = 0; i < distancias.size(); i++) distancias[i][alteracao.cliente] = distancias[alteracao.cliente][i] = 0;
+    }
+    inicio = high_resolution_clock::now();
+    Solucao doZero = resolver(pedido, demandas, distancias);
+    fim = high_resolution_clock::now();
+    cout << "Resolvendo do zero: custo " << doZero.custo << ", " << duration_cast<microseconds>(fim - inicio).count() << " us" << endl;
+
+    return 0;
+}
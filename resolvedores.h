@@ -0,0 +1,345 @@
+#ifndef RESOLVEDORES_H
+#define RESOLVEDORES_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "buscaglobal.h"
+#include "cache.h"
+#include "clarke.h"
+#include "greedy.h"
+#include "limitantes.h"
+
+// Chamada única para qualquer um dos resolvedores, sem impressão na saída padrão, para os programas que
+// resolvem muitas instâncias no mesmo processo (lote.cpp, servidor.cpp).
+
+struct PedidoSolucao {
+    string resolvedor = "clarke";   // clarke, greedy, buscaglobal ou portfolio
+    int capacidade = 15;
+    int maxParadas = 5;             // conta a saída e a volta ao depósito, como nos programas isolados
+    long long tempoLimiteMs = 0;
+    long long maxIteracoes = 0;
+    bool calcularLimitante = false; // sempre calculado no portfolio
+    double toleranciaGap = 0;       // portfolio: para no primeiro resolvedor com gap (%) até este valor
+    vector<vector<int>> solucaoInicial;     // solução viável já conhecida: incumbente inicial da busca global e do portfolio
+};
+
+struct Solucao {
+    int custo = -1;
+    vector<vector<int>> rotas;
+    bool limiteAtingido = false;
+    long long tempoMs = 0;
+    string erro;                    // vazio se a instância foi resolvida
+    long long limitante = -1;       // limitante inferior (limitantes.h), se pedido
+    double gap = -1;                // gap em %, se há limitante e a solução é viável
+    string resolvedorUsado;         // no portfolio, o resolvedor que produziu a solução
+    bool doCache = false;           // respondida pelo cache em disco (cache.h), sem resolver
+};
+
+// Estruturas que dependem só da instância (e de capacidade/maxParadas), guardadas entre resoluções pelo servidor:
+// a lista ordenada de economias do Clarke e Wright e os conjuntos de rotas da busca global.
+// Preenchidas sob demanda; a trava permite que várias threads resolvam a mesma instância.
+struct EstruturasDerivadas {
+    mutex trava;
+    shared_ptr<const vector<Economia>> economias;
+    map<pair<int, int>, shared_ptr<const PoolSequencias>> rotasPossiveis;   // (capacidade, maxParadas) -> rotas
+    bool temChaveConteudo = false;
+    uint64_t chaveConteudo = 0;     // chaveConteudoInstancia (cache.h), calculada no primeiro pedido com --cache
+};
+
+inline bool resolvedorValido(const string& nome) {
+    return nome == "clarke" || nome == "greedy" || nome == "buscaglobal" || nome == "portfolio";
+}
+
+inline Solucao resolverPortfolio(const PedidoSolucao& pedido, const vector<int>& demandas, const vector<vector<int>>& distancias,
+                                 EstruturasDerivadas* derivadas);
+inline Solucao resolverComCache(const PedidoSolucao& pedido, const vector<int>& demandas, const vector<vector<int>>& distancias,
+                                EstruturasDerivadas* derivadas);
+
+// Limitante inferior e gap da solução, como pedidos em 'pedido'
+inline void preencherLimitante(const PedidoSolucao& pedido, const vector<int>& demandas, const vector<vector<int>>& distancias,
+                               Solucao& solucao, const Limitante* limitanteConhecido = nullptr) {
+    // a inserção mais próxima não limita o número de clientes por rota
+    int maxClientes = pedido.resolvedor == "greedy" ? 0 : pedido.maxParadas - 2;
+    Limitante limitante = limitanteConhecido ? *limitanteConhecido : calcularLimitante(distancias, demandas, pedido.capacidade, maxClientes);
+    if (!limitante.inviavel) {
+        solucao.limitante = limitante.valor;
+        if (solucaoViavel(solucao.rotas, distancias, demandas, pedido.capacidade, maxClientes)) {
+            solucao.gap = gapPercentual(solucao.custo, limitante);
+        }
+    }
+}
+
+inline Solucao resolverDireto(const PedidoSolucao& pedido, const vector<int>& demandas, const vector<vector<int>>& distancias,
+                              EstruturasDerivadas* derivadas) {
+    Solucao solucao;
+    LimitesExecucao limites;
+    limites.tempoLimiteMs = pedido.tempoLimiteMs;
+    limites.maxIteracoes = pedido.maxIteracoes;
+    limites.reportar = false;
+    int numVertices = distancias.size();
+
+    if (pedido.resolvedor == "clarke") {
+        shared_ptr<const vector<Economia>> economias;
+        if (derivadas) {
+            {
+                lock_guard<mutex> lock(derivadas->trava);
+                economias = derivadas->economias;
+            }
+            // calculadas fora da trava, para não segurar os outros pedidos da instância; se dois pedidos calcularem
+            // ao mesmo tempo, fica a lista do primeiro
+            if (!economias) {
+                FaseCronometrada fase("economias");
+                auto calculadas = make_shared<const vector<Economia>>(calcularEconomias(distancias));
+                lock_guard<mutex> lock(derivadas->trava);
+                if (!derivadas->economias) derivadas->economias = calculadas;
+                economias = derivadas->economias;
+            }
+        }
+        solucao.rotas = clarkeWright(distancias, pedido.capacidade, demandas, pedido.maxParadas - 2, limites, economias.get());
+        reordenarRotas(solucao.rotas, distancias);
+        solucao.custo = 0;
+        for (const auto& rota : solucao.rotas) {
+            solucao.custo += calcularCustoRota(rota, distancias);
+        }
+    } else if (pedido.resolvedor == "greedy") {
+        solucao.rotas = insercaoMaisProxima(distancias, demandas, pedido.capacidade, limites);
+        reordenarRotas(solucao.rotas, distancias);
+        solucao.custo = calcularCustoTotal(solucao.rotas, distancias);
+    } else if (pedido.resolvedor == "buscaglobal") {
+        Incumbente incumbente;
+        incumbente.silencioso = true;
+        if (!pedido.solucaoInicial.empty()) {
+            incumbente.oferecer(calcularCustoTotal(pedido.solucaoInicial, distancias), pedido.solucaoInicial, limites);
+        }
+        shared_ptr<const PoolSequencias> rotas;
+        if (derivadas) {
+            auto chave = make_pair(pedido.capacidade, pedido.maxParadas);
+            {
+                lock_guard<mutex> lock(derivadas->trava);
+                auto it = derivadas->rotasPossiveis.find(chave);
+                if (it != derivadas->rotasPossiveis.end()) rotas = it->second;
+            }
+            // gerado fora da trava e com os limites do pedido; um conjunto cortado pelo limite serve só a este pedido
+            if (!rotas) {
+                rotas = make_shared<const PoolSequencias>(gerarRotasPossiveis(distancias, demandas, pedido.capacidade, pedido.maxParadas, limites));
+                if (!limites.esgotado) {
+                    lock_guard<mutex> lock(derivadas->trava);
+                    derivadas->rotasPossiveis.emplace(chave, rotas);
+                }
+            }
+        }
+        buscaGlobal(distancias, demandas, pedido.capacidade, numVertices, pedido.maxParadas, limites, incumbente, rotas.get());
+        if (incumbente.existe()) {
+            solucao.custo = incumbente.custo;
+            solucao.rotas = incumbente.rotas;
+        } else {
+            solucao.erro = "Nenhuma solução viável";
+        }
+    } else if (pedido.resolvedor == "portfolio") {
+        return resolverPortfolio(pedido, demandas, distancias, derivadas);
+    } else {
+        solucao.erro = "Resolvedor desconhecido: " + pedido.resolvedor;
+    }
+
+    if (pedido.calcularLimitante && solucao.erro.empty()) {
+        preencherLimitante(pedido, demandas, distancias, solucao);
+    }
+
+    solucao.limiteAtingido = limites.esgotado;
+    solucao.tempoMs = limites.decorridoMs();
+    return solucao;
+}
+
+inline Solucao resolver(const PedidoSolucao& pedido, const vector<int>& demandas, const vector<vector<int>>& distancias,
+                        EstruturasDerivadas* derivadas = nullptr) {
+    if (cacheAtivo() && resolvedorValido(pedido.resolvedor)) return resolverComCache(pedido, demandas, distancias, derivadas);
+    return resolverDireto(pedido, demandas, distancias, derivadas);
+}
+
+// Portfolio: as heurísticas em ordem de custo (inserção mais próxima, Clarke e Wright) e depois a busca global com o
+// tempo que sobrar, parando assim que a melhor solução viável estiver a até toleranciaGap % do limitante.
+// O limitante usa o limite de clientes por rota (maxParadas - 2), que vale para as três.
+inline Solucao resolverPortfolio(const PedidoSolucao& pedido, const vector<int>& demandas, const vector<vector<int>>& distancias,
+                                 EstruturasDerivadas* derivadas) {
+    auto inicio = chrono::steady_clock::now();
+    auto decorridoMs = [&]() { return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - inicio).count(); };
+    int maxClientes = pedido.maxParadas - 2;
+
+    Solucao melhor;
+    melhor.erro = "Nenhuma solução viável";
+    Limitante limitante = calcularLimitante(distancias, demandas, pedido.capacidade, maxClientes);
+    if (limitante.inviavel) {
+        melhor.erro = "Instância sem solução viável";
+        melhor.tempoMs = decorridoMs();
+        return melhor;
+    }
+
+    if (!pedido.solucaoInicial.empty() && solucaoViavel(pedido.solucaoInicial, distancias, demandas, pedido.capacidade, maxClientes)) {
+        melhor.custo = calcularCustoTotal(pedido.solucaoInicial, distancias);
+        melhor.rotas = pedido.solucaoInicial;
+        melhor.erro.clear();
+        melhor.resolvedorUsado = "inicial";
+        melhor.gap = gapPercentual(melhor.custo, limitante);
+    }
+
+    for (const char* nome : {"greedy", "clarke", "buscaglobal"}) {
+        if (melhor.erro.empty() && melhor.gap <= pedido.toleranciaGap) break;
+        PedidoSolucao etapa = pedido;
+        etapa.resolvedor = nome;
+        etapa.calcularLimitante = false;
+        etapa.solucaoInicial = melhor.erro.empty() ? melhor.rotas : vector<vector<int>>();
+        if (pedido.tempoLimiteMs > 0) {
+            etapa.tempoLimiteMs = pedido.tempoLimiteMs - decorridoMs();
+            if (etapa.tempoLimiteMs <= 0) {
+                melhor.limiteAtingido = true;
+                break;
+            }
+        }
+        Solucao solucao = resolver(etapa, demandas, distancias, derivadas);
+        melhor.limiteAtingido = solucao.limiteAtingido;
+        bool viavel = solucao.erro.empty() && solucaoViavel(solucao.rotas, distancias, demandas, pedido.capacidade, maxClientes);
+        if (viavel && (!melhor.erro.empty() || solucao.custo < melhor.custo)) {
+            melhor.custo = solucao.custo;
+            melhor.rotas = solucao.rotas;
+            melhor.erro.clear();
+            melhor.resolvedorUsado = nome;
+            melhor.gap = gapPercentual(melhor.custo, limitante);
+        }
+    }
+
+    melhor.limitante = limitante.valor;
+    if (!melhor.erro.empty()) melhor.gap = -1;
+    melhor.tempoMs = decorridoMs();
+    return melhor;
+}
+
+// Resolve pelo cache em disco (cache.h). Um pedido igual já resolvido sem atingir limite de execução é respondido
+// com a solução guardada. Senão o pedido é resolvido partindo da melhor solução conhecida da instância, e os dois
+// registros são atualizados. Dois processos podem gravar a melhor solução ao mesmo tempo e o último prevalece,
+// mesmo que seja pior: ela é só um ponto de partida.
+inline Solucao resolverComCache(const PedidoSolucao& pedido, const vector<int>& demandas, const vector<vector<int>>& distancias,
+                                EstruturasDerivadas* derivadas) {
+    auto inicio = chrono::steady_clock::now();
+    int numVertices = distancias.size();
+    int maxClientes = pedido.maxParadas - 2;
+    // o hash do conteúdo percorre a matriz inteira: no servidor fica com a instância, como as economias
+    bool temConteudo = false;
+    uint64_t conteudo = 0;
+    if (derivadas) {
+        lock_guard<mutex> lock(derivadas->trava);
+        temConteudo = derivadas->temChaveConteudo;
+        conteudo = derivadas->chaveConteudo;
+    }
+    if (!temConteudo) {
+        FaseCronometrada fase("chave_cache");
+        conteudo = chaveConteudoInstancia(demandas, distancias);
+        if (derivadas) {
+            lock_guard<mutex> lock(derivadas->trava);
+            derivadas->chaveConteudo = conteudo;
+            derivadas->temChaveConteudo = true;
+        }
+    }
+    uint64_t instancia = chaveInstancia(conteudo, pedido.capacidade, pedido.maxParadas);
+    uint64_t chave = chavePedido(instancia, pedido.resolvedor, pedido.toleranciaGap);
+    string arquivoPedido = arquivoCache(chave, "sol");
+    string arquivoMelhor = arquivoCache(instancia, "melhor");
+
+    RegistroCache guardado;
+    bool temGuardado = lerRegistroCache(arquivoPedido, chave, numVertices, guardado);
+    // o registro só responde o pedido se a solução for viável nesta instância e tiver o custo gravado; senão é
+    // tratado como falta e sobrescrito (a inserção mais próxima não limita os clientes por rota)
+    if (temGuardado) {
+        int maxClientesResolvedor = pedido.resolvedor == "greedy" ? 0 : maxClientes;
+        temGuardado = solucaoViavel(guardado.rotas, distancias, demandas, pedido.capacidade, maxClientesResolvedor) &&
+                      calcularCustoTotal(guardado.rotas, distancias) == guardado.custo;
+    }
+    bool precisaLimitante = pedido.calcularLimitante || pedido.resolvedor == "portfolio";
+    if (temGuardado && !guardado.limiteAtingido && (!precisaLimitante || guardado.limitante >= 0)) {
+        cacheSolucoes().acertos++;
+        Solucao solucao;
+        solucao.custo = guardado.custo;
+        solucao.rotas = guardado.rotas;
+        solucao.doCache = true;
+        if (pedido.resolvedor == "portfolio") solucao.resolvedorUsado = guardado.resolvedor;
+        if (precisaLimitante) {
+            Limitante limitante;
+            limitante.valor = guardado.limitante;
+            preencherLimitante(pedido, demandas, distancias, solucao, &limitante);
+        }
+        solucao.tempoMs = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - inicio).count();
+        return solucao;
+    }
+    cacheSolucoes().faltas++;
+
+    RegistroCache melhor;
+    bool temMelhor = lerRegistroCache(arquivoMelhor, instancia, numVertices, melhor) &&
+                     solucaoViavel(melhor.rotas, distancias, demandas, pedido.capacidade, maxClientes);
+    PedidoSolucao aquecido = pedido;
+    if (temMelhor && aquecido.solucaoInicial.empty()) aquecido.solucaoInicial = melhor.rotas;
+
+    Solucao solucao = resolverDireto(aquecido, demandas, distancias, derivadas);
+    if (!solucao.erro.empty()) return solucao;
+
+    if (!temGuardado || !solucao.limiteAtingido || solucao.custo < guardado.custo) {
+        RegistroCache registro;
+        registro.custo = solucao.custo;
+        registro.limitante = solucao.limitante;
+        registro.limiteAtingido = solucao.limiteAtingido;
+        registro.resolvedor = solucao.resolvedorUsado.empty() ? pedido.resolvedor : solucao.resolvedorUsado;
+        registro.rotas = solucao.rotas;
+        gravarRegistroCache(arquivoPedido, chave, numVertices, registro);
+    }
+    if (solucaoViavel(solucao.rotas, distancias, demandas, pedido.capacidade, maxClientes)) {
+        int custo = calcularCustoTotal(solucao.rotas, distancias);
+        if (!temMelhor || custo < calcularCustoTotal(melhor.rotas, distancias)) {
+            RegistroCache registro;
+            registro.custo = custo;
+            registro.limitante = solucao.limitante;
+            registro.resolvedor = solucao.resolvedorUsado.empty() ? pedido.resolvedor : solucao.resolvedorUsado;
+            registro.rotas = solucao.rotas;
+            gravarRegistroCache(arquivoMelhor, instancia, numVertices, registro);
+        }
+    }
+    return solucao;
+}
+
+inline string escaparJson(const string& texto) {
+    string saida;
+    for (char c : texto) {
+        if (c == '"' || c == '\\') saida += '\\';
+        if (c == '\n') { saida += "\\n"; continue; }
+        saida += c;
+    }
+    return saida;
+}
+
+// Campos da solução em JSON (sem as chaves externas), para compor registros maiores
+inline string solucaoEmJson(const Solucao& solucao) {
+    ostringstream json;
+    if (!solucao.erro.empty()) {
+        json << "\"erro\": \"" << escaparJson(solucao.erro) << "\"";
+        return json.str();
+    }
+    json << "\"custo\": " << solucao.custo << ", \"rotas\": [";
+    for (size_t r = 0; r < solucao.rotas.size(); r++) {
+        json << (r ? ", [" : "[");
+        for (size_t i = 0; i < solucao.rotas[r].size(); i++) {
+            json << (i ? ", " : "") << solucao.rotas[r][i];
+        }
+        json << "]";
+    }
+    json << "], \"tempo_ms\": " << solucao.tempoMs << ", \"limite_atingido\": " << (solucao.limiteAtingido ? "true" : "false");
+    if (solucao.limitante >= 0) json << ", \"limitante\": " << solucao.limitante;
+    if (solucao.gap >= 0) json << ", \"gap\": " << solucao.gap;
+    if (!solucao.resolvedorUsado.empty()) json << ", \"resolvedor_usado\": \"" << solucao.resolvedorUsado << "\"";
+    if (solucao.doCache) json << ", \"cache\": true";
+    return json.str();
+}
+
+#endif
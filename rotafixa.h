@@ -0,0 +1,57 @@
+#ifndef ROTAFIXA_H
+#define ROTAFIXA_H
+
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+// Rota de capacidade fixa, guardada dentro do próprio objeto, para os laços internos da busca global.
+// MaxParadas conta a saída e a volta ao depósito (0 a b c 0 tem 5 paradas), como o maxParadas dos programas.
+// Montar, comparar e copiar uma RotaFixa não aloca memória; a interface imita a parte de vector<int>
+// usada pelos kernels (size, [], push_back, clear, begin/end), que por isso são templados no tipo da rota.
+
+template <int MaxParadas>
+struct RotaFixa {
+    int nos[MaxParadas];
+    uint8_t tamanho = 0;
+
+    size_t size() const { return tamanho; }
+    int operator[](size_t i) const { return nos[i]; }
+    void clear() { tamanho = 0; }
+    void push_back(int no) { nos[tamanho++] = no; }
+    const int* begin() const { return nos; }
+    const int* end() const { return nos + tamanho; }
+
+    bool operator==(const RotaFixa& outra) const {
+        if (tamanho != outra.tamanho) return false;
+        for (int i = 0; i < tamanho; i++) {
+            if (nos[i] != outra.nos[i]) return false;
+        }
+        return true;
+    }
+
+    std::vector<int> vetor() const { return std::vector<int>(begin(), end()); }
+};
+
+inline const std::vector<int>& paraVetor(const std::vector<int>& rota) { return rota; }
+
+template <int MaxParadas>
+std::vector<int> paraVetor(const RotaFixa<MaxParadas>& rota) { return rota.vetor(); }
+
+// Menor e maior maxParadas com instanciação própria; fora da faixa os resolvedores usam vector<int>
+const int MIN_PARADAS_FIXAS = 3;
+const int MAX_PARADAS_FIXAS = 8;
+
+// Chama funcao(std::integral_constant<int, maxParadas>) para maxParadas em [3, 8], ou funcao(std::integral_constant<int, 0>)
+// fora da faixa, para que o chamador escolha a versão genérica.
+template <int M = MIN_PARADAS_FIXAS, typename Funcao>
+auto despacharMaxParadas(int maxParadas, Funcao&& funcao) {
+    if constexpr (M > MAX_PARADAS_FIXAS) {
+        return funcao(std::integral_constant<int, 0>());
+    } else {
+        if (maxParadas == M) return funcao(std::integral_constant<int, M>());
+        return despacharMaxParadas<M + 1>(maxParadas, funcao);
+    }
+}
+
+#endif
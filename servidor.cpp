@@ -0,0 +1,240 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "resolvedores.h"
+
+using namespace std;
+
+// Servidor residente: mantém instâncias carregadas na memória (matriz, demandas e as estruturas derivadas de
+// resolvedores.h) e atende pedidos de resolução por um socket Unix, sem reiniciar o processo nem reler o arquivo.
+//
+// Protocolo: uma linha de texto por pedido, uma linha JSON por resposta. Cada conexão pode mandar vários pedidos.
+//   carregar <nome> <arquivo>                                     lê a instância e a guarda como <nome>
+//   resolver <nome> [resolvedor] [capacidade] [maxParadas] [tempoLimiteMs] [toleranciaGap]   (toleranciaGap só no portfolio)
+//   descarregar <nome>
+//   listar
+//   encerrar
+// Cada conexão é atendida por uma thread; pedidos sobre a mesma instância podem rodar em paralelo.
+
+struct InstanciaResidente {
+    string arquivo;
+    int numVertices = 0;
+    vector<int> demandas;
+    vector<vector<int>> distancias;
+    EstruturasDerivadas derivadas;
+};
+
+mutex travaInstancias;
+map<string, shared_ptr<InstanciaResidente>> instancias;
+atomic<bool> encerrando{false};
+int socketEscuta = -1;
+
+// Conexões ainda atendidas: ao encerrar, main espera que todas terminem antes de destruir o estado global
+mutex travaConexoes;
+condition_variable conexoesEncerradas;
+set<int> conexoesAbertas;
+
+string respostaErro(const string& mensagem) {
+    return "{\"ok\": false, \"erro\": \"" + escaparJson(mensagem) + "\"}";
+}
+
+string carregar(const string& nome, const string& arquivo) {
+    auto instancia = make_shared<InstanciaResidente>();
+    instancia->arquivo = arquivo;
+    string erro;
+    {
+        FaseCronometrada fase("leitura");
+        erro = LerInstancia(arquivo, instancia->numVertices, instancia->demandas, instancia->distancias);
+    }
+    if (!erro.empty()) return respostaErro(erro);
+
+    lock_guard<mutex> lock(travaInstancias);
+    instancias[nome] = instancia;   // substitui a anterior; quem ainda a estiver resolvendo mantém sua cópia
+    return "{\"ok\": true, \"nome\": \"" + escaparJson(nome) + "\", \"vertices\": " + to_string(instancia->numVertices) + "}";
+}
+
+// Lê o próximo campo opcional de 'campos' em 'valor'. Falso se o campo existe mas não é um valor válido do tipo
+template <class T>
+bool lerCampoOpcional(istream& campos, T& valor, string& campo) {
+    if (!(campos >> campo)) return true;
+    istringstream conversor(campo);
+    T lido;
+    if (!(conversor >> lido) || !conversor.eof()) return false;
+    valor = lido;
+    return true;
+}
+
+shared_ptr<InstanciaResidente> buscar(const string& nome) {
+    lock_guard<mutex> lock(travaInstancias);
+    auto it = instancias.find(nome);
+    return it == instancias.end() ? nullptr : it->second;
+}
+
+string atender(const string& linha) {
+    stringstream campos(linha);
+    string comando;
+    campos >> comando;
+
+    if (comando == "carregar") {
+        string nome, arquivo;
+        if (!(campos >> nome >> arquivo)) return respostaErro("uso: carregar <nome> <arquivo>");
+        return carregar(nome, arquivo);
+    }
+    if (comando == "resolver") {
+        string nome;
+        if (!(campos >> nome)) return respostaErro("uso: resolver <nome> [resolvedor] [capacidade] [maxParadas] [tempoLimiteMs] [toleranciaGap]");
+        PedidoSolucao pedido;
+        string resolvedor;
+        if (campos >> resolvedor) pedido.resolvedor = resolvedor;
+        string campo;
+        if (!lerCampoOpcional(campos, pedido.capacidade, campo) || !lerCampoOpcional(campos, pedido.maxParadas, campo) ||
+            !lerCampoOpcional(campos, pedido.tempoLimiteMs, campo) || !lerCampoOpcional(campos, pedido.toleranciaGap, campo)) {
+            return respostaErro("Campo inválido: '" + campo + "'");
+        }
+        if (!resolvedorValido(pedido.resolvedor)) return respostaErro("Resolvedor desconhecido: " + pedido.resolvedor);
+
+        shared_ptr<InstanciaResidente> instancia = buscar(nome);
+        if (!instancia) return respostaErro("Instância não carregada: " + nome);
+        FaseCronometrada fase("resolucao");
+        Solucao solucao = resolver(pedido, instancia->demandas, instancia->distancias, &instancia->derivadas);
+        if (!solucao.erro.empty()) return respostaErro(solucao.erro);
+        return "{\"ok\": true, " + solucaoEmJson(solucao) + "}";
+    }
+    if (comando == "descarregar") {
+        string nome;
+        campos >> nome;
+        lock_guard<mutex> lock(travaInstancias);
+        if (!instancias.erase(nome)) return respostaErro("Instância não carregada: " + nome);
+        return "{\"ok\": true}";
+    }
+    if (comando == "listar") {
+        lock_guard<mutex> lock(travaInstancias);
+        string resposta = "{\"ok\": true, \"instancias\": [";
+        bool primeira = true;
+        for (const auto& [nome, instancia] : instancias) {
+            resposta += string(primeira ? "" : ", ") + "{\"nome\": \"" + escaparJson(nome) + "\", \"arquivo\": \"" + escaparJson(instancia->arquivo)
+                      + "\", \"vertices\": " + to_string(instancia->numVertices) + "}";
+            primeira = false;
+        }
+        return resposta + "]}";
+    }
+    if (comando == "encerrar") {
+        encerrando = true;
+        return "{\"ok\": true}";
+    }
+    return respostaErro("Comando desconhecido: " + comando);
+}
+
+void fecharConexao(int conexao) {
+    lock_guard<mutex> lock(travaConexoes);
+    conexoesAbertas.erase(conexao);
+    close(conexao);     // sob a trava: main nunca faz shutdown num descritor já reaproveitado
+    conexoesEncerradas.notify_all();
+}
+
+void atenderConexao(int conexao) {
+    string pendente;
+    char buffer[4096];
+    ssize_t lidos;
+    while ((lidos = read(conexao, buffer, sizeof(buffer))) > 0) {
+        pendente.append(buffer, lidos);
+        size_t fimLinha;
+        while ((fimLinha = pendente.find('\n')) != string::npos) {
+            string linha = pendente.substr(0, fimLinha);
+            pendente.erase(0, fimLinha + 1);
+            if (linha.find_first_not_of(" \t\r") == string::npos) continue;
+
+            string resposta = atender(linha) + "\n";
+            size_t enviados = 0;
+            while (enviados < resposta.size()) {
+                ssize_t n = write(conexao, resposta.data() + enviados, resposta.size() - enviados);
+                if (n <= 0) { fecharConexao(conexao); return; }
+                enviados += n;
+            }
+            if (encerrando) {
+                shutdown(socketEscuta, SHUT_RDWR);  // depois da resposta: desbloqueia o accept do laço principal
+            }
+        }
+    }
+    fecharConexao(conexao);
+}
+
+int main(int argc, char* argv[]) {
+    string caminho = "/tmp/vrp.sock";
+    vector<pair<string, string>> precarregar;     // nome=arquivo
+
+    for (int i = 1; i < argc; i++) {
+        string opcao = argv[i];
+        if (opcao == "--socket" && i + 1 < argc) caminho = argv[++i];
+        else if ((opcao == "--estatisticas" || opcao == "--rastreamento" || opcao == "--eventos-por-thread" ||
+                  opcao == "--memoria-max" || opcao == "--dir-temporario" || opcao == "--cache") && i + 1 < argc) i++;
+        else {
+            size_t igual = opcao.find('=');
+            if (igual == string::npos) precarregar.push_back({opcao, opcao});
+            else precarregar.push_back({opcao.substr(0, igual), opcao.substr(igual + 1)});
+        }
+    }
+    LerInstrumentacao(argc, argv, "servidor");
+    LerOrcamentoMemoria(argc, argv);
+    LerCache(argc, argv);
+    signal(SIGPIPE, SIG_IGN);     // cliente que fecha a conexão antes da resposta não derruba o servidor
+
+    for (const auto& [nome, arquivo] : precarregar) {
+        cout << carregar(nome, arquivo) << endl;
+    }
+
+    sockaddr_un endereco{};
+    endereco.sun_family = AF_UNIX;
+    if (caminho.size() >= sizeof(endereco.sun_path)) {
+        cerr << "Caminho do socket muito longo: " << caminho << endl;
+        return 1;
+    }
+    strcpy(endereco.sun_path, caminho.c_str());
+
+    socketEscuta = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(caminho.c_str());
+    if (socketEscuta < 0 || bind(socketEscuta, (sockaddr*)&endereco, sizeof(endereco)) < 0 || listen(socketEscuta, 64) < 0) {
+        perror("Erro ao abrir o socket");
+        return 1;
+    }
+    cout << "Servidor escutando em " << caminho << endl;
+
+    while (!encerrando) {
+        int conexao = accept(socketEscuta, nullptr, nullptr);
+        if (conexao < 0) {
+            if (encerrando || errno != EINTR) break;
+            continue;
+        }
+        {
+            lock_guard<mutex> lock(travaConexoes);
+            conexoesAbertas.insert(conexao);
+        }
+        thread(atenderConexao, conexao).detach();
+    }
+
+    {
+        // conexões ociosas deixam de esperar por pedidos; as que estão resolvendo terminam e respondem antes de sair
+        unique_lock<mutex> lock(travaConexoes);
+        for (int conexao : conexoesAbertas) shutdown(conexao, SHUT_RD);
+        conexoesEncerradas.wait(lock, [] { return conexoesAbertas.empty(); });
+    }
+    close(socketEscuta);
+    unlink(caminho.c_str());
+    cout << "Servidor encerrado" << endl;
+    return 0;
+}
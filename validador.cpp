@@ -0,0 +1,182 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <memory>
+#include <omp.h>
+
+#include "vrp.h"
+#include "matriz.h"
+#include "coordenadas.h"
+#include "arquivosolucao.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Validador de soluções (arquivos de --solucao, arquivosolucao.h) contra a instância: cobertura (cada cliente em
+// exatamente uma rota), capacidade, número de paradas, existência dos arcos e custo declarado. As rotas são lidas
+// e verificadas em paralelo com OpenMP; a cobertura usa um contador por cliente com incremento atômico.
+//   ./validador <solucao> [--instancia grafo.txt] [--capacidade C] [--max-paradas m]
+// A capacidade e o maxParadas vêm do cabeçalho da solução, a menos que sejam passados na linha de comando.
+// Retorna 0 se a solução é válida, 1 se não é e 2 se um dos arquivos não pôde ser lido.
+
+const int EXEMPLOS_POR_PROBLEMA = 5;
+
+enum Problema { MAL_FORMADA, ARCO_INEXISTENTE, ACIMA_DA_CAPACIDADE, ACIMA_DAS_PARADAS, NUM_PROBLEMAS };
+
+const char* nomesProblemas[NUM_PROBLEMAS] = {"mal formadas (depósito, nó fora da instância ou sem clientes)", "com arco inexistente",
+                                             "acima da capacidade", "acima do máximo de paradas"};
+
+struct ResultadoValidacao {
+    long long rotasComProblema[NUM_PROBLEMAS] = {0};
+    vector<long long> exemplos[NUM_PROBLEMAS];     // índices das primeiras rotas com cada problema
+    long long repetidos = 0;                        // visitas a clientes já atendidos por outra rota
+    long long naoAtendidos = 0;
+    long long custo = 0;
+    long long paradas = 0;
+};
+
+template <typename Matriz>
+ResultadoValidacao validar(const SolucaoLida& solucao, const Matriz& distancias, const vector<int>& demandas, int capacidade, int maxParadas) {
+    ResultadoValidacao resultado;
+    const int numVertices = demandas.size();
+    const long long numRotas = solucao.numRotas();
+    vector<int> visitas(numVertices, 0);
+    long long custo = 0, paradas = 0, repetidos = 0;
+    long long contagem[NUM_PROBLEMAS] = {0};
+
+    #pragma omp parallel reduction(+:custo, paradas, repetidos) reduction(+:contagem[:NUM_PROBLEMAS])
+    {
+        vector<long long> exemplos[NUM_PROBLEMAS];
+        #pragma omp for schedule(dynamic, 1024) nowait
+        for (long long r = 0; r < numRotas; r++) {
+            const int* rota = solucao.nos.data() + solucao.inicios[r];
+            const long long tamanho = solucao.inicios[r + 1] - solucao.inicios[r];
+            bool problema[NUM_PROBLEMAS] = {false};
+            paradas += tamanho;
+
+            if (tamanho < 3 || rota[0] != 0 || rota[tamanho - 1] != 0) problema[MAL_FORMADA] = true;
+            long long carga = 0;
+            for (long long i = 0; i < tamanho; i++) {
+                int no = rota[i];
+                if (no < 0 || no >= numVertices || (no == 0 && i > 0 && i + 1 < tamanho)) {
+                    problema[MAL_FORMADA] = true;
+                    continue;
+                }
+                if (i + 1 < tamanho) {
+                    int proximo = rota[i + 1];
+                    if (proximo >= 0 && proximo < numVertices) {
+                        int arco = no == proximo ? 0 : (int)distancias[no][proximo];
+                        if (arco == 0) problema[ARCO_INEXISTENTE] = true;
+                        custo += arco;
+                    }
+                }
+                if (no == 0) continue;
+                carga += demandas[no];
+                int anteriores;
+                #pragma omp atomic capture
+                anteriores = visitas[no]++;
+                if (anteriores > 0) repetidos++;
+            }
+            if (carga > capacidade) problema[ACIMA_DA_CAPACIDADE] = true;
+            if (maxParadas > 0 && tamanho > maxParadas) problema[ACIMA_DAS_PARADAS] = true;
+
+            for (int p = 0; p < NUM_PROBLEMAS; p++) {
+                if (!problema[p]) continue;
+                contagem[p]++;
+                if (exemplos[p].size() < EXEMPLOS_POR_PROBLEMA) exemplos[p].push_back(r);
+            }
+        }
+        #pragma omp critical(exemplos_validacao)
+        for (int p = 0; p < NUM_PROBLEMAS; p++) {
+            resultado.exemplos[p].insert(resultado.exemplos[p].end(), exemplos[p].begin(), exemplos[p].end());
+        }
+    }
+
+    long long naoAtendidos = 0;
+    #pragma omp parallel for reduction(+:naoAtendidos)
+    for (int cliente = 1; cliente < numVertices; cliente++) {
+        if (visitas[cliente] == 0) naoAtendidos++;
+    }
+
+    for (int p = 0; p < NUM_PROBLEMAS; p++) {
+        resultado.rotasComProblema[p] = contagem[p];
+        sort(resultado.exemplos[p].begin(), resultado.exemplos[p].end());
+        if (resultado.exemplos[p].size() > EXEMPLOS_POR_PROBLEMA) resultado.exemplos[p].resize(EXEMPLOS_POR_PROBLEMA);
+    }
+    resultado.repetidos = repetidos;
+    resultado.naoAtendidos = naoAtendidos;
+    resultado.custo = custo;
+    resultado.paradas = paradas;
+    return resultado;
+}
+
+int main(int argc, char* argv[]) {
+    string arquivoSolucao;
+    string arquivoInstancia = "grafo.txt";
+    int capacidade = -1, maxParadas = -1;
+    for (int i = 1; i < argc; i++) {
+        string opcao = argv[i];
+        if (opcao == "--instancia" && i + 1 < argc) arquivoInstancia = argv[++i];
+        else if (opcao == "--capacidade" && i + 1 < argc) capacidade = atoi(argv[++i]);
+        else if (opcao == "--max-paradas" && i + 1 < argc) maxParadas = atoi(argv[++i]);
+        else arquivoSolucao = opcao;
+    }
+    if (arquivoSolucao.empty()) {
+        cerr << "uso: ./validador <solucao> [--instancia grafo.txt] [--capacidade C] [--max-paradas m]" << endl;
+        return 2;
+    }
+
+    auto inicioLeitura = high_resolution_clock::now();
+    SolucaoLida solucao;
+    string erro = LerSolucao(arquivoSolucao, solucao);
+    if (!erro.empty()) {
+        cerr << erro << endl;
+        return 2;
+    }
+    long long msLeituraSolucao = duration_cast<milliseconds>(high_resolution_clock::now() - inicioLeitura).count();
+    if (capacidade < 0) capacidade = solucao.cabecalho.capacidade;
+    if (maxParadas < 0) maxParadas = solucao.cabecalho.maxParadas;
+
+    int numVertices;
+    vector<int> demandas;
+    vector<vector<int>> distancias;
+    unique_ptr<MatrizCoordenadas> coordenadas;
+    erro = arquivoCoordenadas(arquivoInstancia) ? LerInstanciaCoordenadas(arquivoInstancia, numVertices, demandas, coordenadas)
+                                                : LerInstancia(arquivoInstancia, numVertices, demandas, distancias);
+    if (!erro.empty()) {
+        cerr << erro << endl;
+        return 2;
+    }
+    if (solucao.cabecalho.vertices != numVertices) {
+        cerr << "A solução é de uma instância com " << solucao.cabecalho.vertices << " vértices e " << arquivoInstancia
+             << " tem " << numVertices << endl;
+        return 2;
+    }
+
+    auto inicio = high_resolution_clock::now();
+    ResultadoValidacao resultado = coordenadas
+        ? validar(solucao, *coordenadas, demandas, capacidade, maxParadas)
+        : comMatrizCompacta(move(distancias), [&](const auto& matriz) { return validar(solucao, matriz, demandas, capacidade, maxParadas); });
+    double ms = duration_cast<microseconds>(high_resolution_clock::now() - inicio).count() / 1000.0;
+
+    bool valida = resultado.repetidos == 0 && resultado.naoAtendidos == 0 && resultado.custo == solucao.cabecalho.custo;
+    cout << "Solução " << arquivoSolucao << " (" << solucao.cabecalho.programa << "): " << solucao.numRotas() << " rotas, "
+         << resultado.paradas << " paradas\n";
+    cout << "Clientes: " << numVertices - 1 - resultado.naoAtendidos << " de " << numVertices - 1 << " atendidos, "
+         << resultado.naoAtendidos << " não atendidos, " << resultado.repetidos << " visitas repetidas\n";
+    for (int p = 0; p < NUM_PROBLEMAS; p++) {
+        if (resultado.rotasComProblema[p] == 0) continue;
+        valida = false;
+        cout << "Rotas " << nomesProblemas[p] << ": " << resultado.rotasComProblema[p] << " (e.g. rota";
+        for (long long r : resultado.exemplos[p]) cout << " " << r;
+        cout << ")\n";
+    }
+    cout << "Custo declarado: " << solucao.cabecalho.custo << ", recalculado: " << resultado.custo << "\n";
+    cout << "Capacidade " << capacidade << ", máximo de paradas " << (maxParadas > 0 ? to_string(maxParadas) : "sem limite")
+         << (solucao.cabecalho.limiteAtingido ? " (resolvida com limite de execução atingido)" : "") << "\n";
+    cout << (valida ? "Solução válida" : "Solução inválida") << "\n";
+    cout << "Validação: " << ms << " ms (" << (ms > 0 ? resultado.paradas / ms / 1000.0 : 0) << " milhões de paradas/s, "
+         << omp_get_max_threads() << " threads); leitura da solução: " << msLeituraSolucao << " ms" << endl;
+    return valida ? 0 : 1;
+}
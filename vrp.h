@@ -0,0 +1,360 @@
+#ifndef VRP_H
+#define VRP_H
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+
+#include "limites.h"
+#include "instrumentacao.h"
+#include "rotafixa.h"
+#include "poolrotas.h"
+#include "avaliacaolote.h"
+
+// Funções de leitura da instância e de avaliação de rotas compartilhadas pelos resolvedores e pelo benchmark
+
+using namespace std;
+
+// Verifica se o arquivo está no formato binário gerado por ./geraGrafo --binario (começa com "VRPB")
+inline bool arquivoBinario(const string& nomeArquivo) {
+    ifstream arquivo(nomeArquivo, ios::binary);
+    char magica[4] = {0};
+    arquivo.read(magica, 4);
+    return arquivo.gcount() == 4 && memcmp(magica, "VRPB", 4) == 0;
+}
+
+// Maior número de nós aceito num arquivo binário: a matriz densa numVertices x numVertices ainda é indexável com int
+const int32_t MAX_NOS_BINARIO = 46340;
+
+// Le o cabeçalho do formato binário e as demandas; deixa o arquivo posicionado no número de arcos
+inline vector<int> LerCabecalhoBinario(ifstream& arquivo, const string& nomeArquivo, int& numVertices) {
+    char magica[4];
+    int32_t versao, numNos;
+    arquivo.read(magica, 4);
+    arquivo.read(reinterpret_cast<char*>(&versao), sizeof(versao));
+    arquivo.read(reinterpret_cast<char*>(&numNos), sizeof(numNos));
+    if (!arquivo || versao != 1 || numNos < 1 || numNos > MAX_NOS_BINARIO) {
+        cerr << "Formato binário inválido em " << nomeArquivo << endl;
+        exit(1);
+    }
+    numVertices = numNos;
+
+    vector<int> demandas(numVertices, 0);
+    vector<int32_t> lidas(numVertices - 1);
+    arquivo.read(reinterpret_cast<char*>(lidas.data()), lidas.size() * sizeof(int32_t));
+    if (arquivo.gcount() != (streamsize)(lidas.size() * sizeof(int32_t))) {
+        cerr << "Demanda inválida em " << nomeArquivo << ": arquivo truncado" << endl;
+        exit(1);
+    }
+    for (size_t i = 0; i < lidas.size(); i++) {
+        demandas[i + 1] = lidas[i];
+    }
+    return demandas;
+}
+
+// Le o arquivo de entrada e retorna um vetor com as demandas de cada vertice e atualiza o numero de vertices
+inline vector<int> LerDestinoDemanda(const string& nomeArquivo, int& numVertices) {
+    if (arquivoBinario(nomeArquivo)) {
+        ifstream binario(nomeArquivo, ios::binary);
+        return LerCabecalhoBinario(binario, nomeArquivo, numVertices);
+    }
+
+    ifstream arquivo(nomeArquivo);
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo " << nomeArquivo << endl;
+        exit(1);
+    }
+    
+    arquivo >> numVertices;
+
+    vector<int> grafo(numVertices, 0);
+    int destino, demanda;
+    for (int i = 1; i < numVertices; i++) {
+        arquivo >> destino >> demanda;
+        grafo[destino] = demanda;
+    }
+    arquivo.close();
+    return grafo;
+}
+
+// Le o arquivo de entrada e retorna um vetor com as rotas possiveis e atualiza o numero de vertices
+inline vector<vector<int>> LerRotasPossiveis(const string& nomeArquivo, int& numVertices) {
+    if (arquivoBinario(nomeArquivo)) {
+        ifstream binario(nomeArquivo, ios::binary);
+        LerCabecalhoBinario(binario, nomeArquivo, numVertices);
+        int64_t numArcos;
+        binario.read(reinterpret_cast<char*>(&numArcos), sizeof(numArcos));
+
+        vector<vector<int>> grafo(numVertices, vector<int>(numVertices, 0));
+        // le os arcos em blocos para nao pagar uma chamada de leitura por arco
+        vector<int32_t> trios(3 * 65536);
+        while (numArcos > 0 && binario) {
+            int64_t lote = min<int64_t>(numArcos, 65536);
+            binario.read(reinterpret_cast<char*>(trios.data()), lote * 3 * sizeof(int32_t));
+            if (binario.gcount() != (streamsize)(lote * 3 * sizeof(int32_t))) break;
+            for (int64_t k = 0; k < lote; k++) {
+                int origem = trios[3 * k], destino = trios[3 * k + 1];
+                if (origem < 0 || origem >= numVertices || destino < 0 || destino >= numVertices) {
+                    cerr << "Arco inválido em " << nomeArquivo << endl;
+                    exit(1);
+                }
+                grafo[origem][destino] = trios[3 * k + 2];     // GRAFO DIRECIONADO!
+            }
+            numArcos -= lote;
+        }
+        if (numArcos > 0) {
+            cerr << "Arquivo truncado: " << nomeArquivo << endl;
+            exit(1);
+        }
+        return grafo;
+    }
+
+    ifstream arquivo(nomeArquivo);
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo " << nomeArquivo << endl;
+        exit(1);
+    }
+
+    arquivo >> numVertices;
+     
+    // ignora as proximas numVertices-1 linhas (sao as demandas dos vertices lidas anteriormente)
+    for (int i = 0; i < numVertices-1; i++) {
+        int x, y;
+        arquivo >> x >> y;
+    }
+
+    // le a quantidade de rotas possiveis
+    int numRotas;
+    arquivo >> numRotas;
+
+    // cria um grafo com numVertices vertices e inicializa com 0 e le as rotas
+    vector<vector<int>> grafo(numVertices, vector<int>(numVertices, 0));
+
+    int origem, destino, custo;
+    while (arquivo >> origem >> destino >> custo) {
+        grafo[origem][destino] = custo;     // GRAFO DIRECIONADO!
+    }
+    arquivo.close();
+    return grafo;
+}
+
+// Le demandas e arcos numa única passada pelo arquivo (texto ou binário), reaproveitando a memória já alocada em
+// 'demandas' e 'distancias'. Usada quando muitas instâncias são lidas pelo mesmo processo: em vez de encerrar o
+// programa, devolve a mensagem de erro (vazia se a leitura deu certo).
+inline string LerInstancia(const string& nomeArquivo, int& numVertices, vector<int>& demandas, vector<vector<int>>& distancias) {
+    ifstream arquivo(nomeArquivo, ios::binary);
+    if (!arquivo.is_open()) {
+        return "Erro ao abrir o arquivo " + nomeArquivo;
+    }
+
+    auto prepararMatriz = [&]() {
+        distancias.resize(numVertices);
+        for (auto& linha : distancias) linha.assign(numVertices, 0);
+    };
+
+    char magica[4] = {0};
+    arquivo.read(magica, 4);
+    if (arquivo.gcount() == 4 && memcmp(magica, "VRPB", 4) == 0) {
+        int32_t versao, numNos;
+        arquivo.read(reinterpret_cast<char*>(&versao), sizeof(versao));
+        arquivo.read(reinterpret_cast<char*>(&numNos), sizeof(numNos));
+        if (!arquivo || versao != 1 || numNos < 1 || numNos > MAX_NOS_BINARIO) {
+            return "Formato binário inválido em " + nomeArquivo;
+        }
+        numVertices = numNos;
+        demandas.assign(numVertices, 0);
+        vector<int32_t> lidas(numVertices - 1);
+        arquivo.read(reinterpret_cast<char*>(lidas.data()), lidas.size() * sizeof(int32_t));
+        if (arquivo.gcount() != (streamsize)(lidas.size() * sizeof(int32_t))) {
+            return "Demanda inválida em " + nomeArquivo + ": arquivo truncado";
+        }
+        for (size_t i = 0; i < lidas.size(); i++) {
+            demandas[i + 1] = lidas[i];
+        }
+
+        int64_t numArcos = 0;
+        arquivo.read(reinterpret_cast<char*>(&numArcos), sizeof(numArcos));
+        prepararMatriz();
+        vector<int32_t> trios(3 * 65536);
+        while (numArcos > 0 && arquivo) {
+            int64_t lote = min<int64_t>(numArcos, 65536);
+            arquivo.read(reinterpret_cast<char*>(trios.data()), lote * 3 * sizeof(int32_t));
+            if (arquivo.gcount() != (streamsize)(lote * 3 * sizeof(int32_t))) break;     // último trio cortado
+            for (int64_t k = 0; k < lote; k++) {
+                int origem = trios[3 * k], destino = trios[3 * k + 1];
+                if (origem < 0 || origem >= numVertices || destino < 0 || destino >= numVertices) {
+                    return "Arco inválido em " + nomeArquivo;
+                }
+                distancias[origem][destino] = trios[3 * k + 2];     // GRAFO DIRECIONADO!
+            }
+            numArcos -= lote;
+        }
+        if (numArcos > 0) {
+            return "Arquivo truncado: " + nomeArquivo;
+        }
+        return "";
+    }
+
+    arquivo.clear();
+    arquivo.seekg(0);
+    if (!(arquivo >> numVertices) || numVertices < 1) {
+        return "Número de vértices inválido em " + nomeArquivo;
+    }
+    demandas.assign(numVertices, 0);
+    int destino, demanda;
+    for (int i = 1; i < numVertices; i++) {
+        if (!(arquivo >> destino >> demanda) || destino < 0 || destino >= numVertices) {
+            return "Demanda inválida em " + nomeArquivo;
+        }
+        demandas[destino] = demanda;
+    }
+
+    int numRotas;
+    arquivo >> numRotas;
+    prepararMatriz();
+    int origem, custo;
+    while (arquivo >> origem >> destino >> custo) {
+        if (origem < 0 || origem >= numVertices || destino < 0 || destino >= numVertices) {
+            return "Arco inválido em " + nomeArquivo;
+        }
+        distancias[origem][destino] = custo;     // GRAFO DIRECIONADO!
+    }
+    return "";
+}
+
+// Função para calcular o custo de uma rota (vector<int> ou RotaFixa). 'Custo' permite somar em long long
+// quando a soma das distâncias pode passar de int (instâncias grandes da decomposição)
+template <typename Custo = int, typename Rota, typename Matriz>
+inline Custo calcularCusto(const Rota& rota, const Matriz& rotas) {
+    Custo custo = 0;
+    for (size_t i = 0; i + 1 < rota.size(); ++i) {
+        int origem = rota[i];
+        int destino = rota[i + 1];
+        if (rotas[origem][destino] == 0) {
+            return -1;  // Indica rota inválida
+        }
+        custo += rotas[origem][destino];
+    }
+    return custo;
+}
+
+// Função para verificar se a capacidade do veículo é respeitada. A soma das demandas não pode ultrapassar a capacidade
+template <typename Rota>
+inline int verificaCapacidade(const Rota& rota, const vector<int>& demandas, int capacidadeVeiculo){
+    int carga_total = 0;
+    for (int index : rota){
+        carga_total += demandas[index];
+    }
+    if (carga_total > capacidadeVeiculo){
+        return 0;
+    }
+
+    return 1;
+}
+
+// Soma das demandas dos clientes da rota (sem o depósito nas pontas)
+inline int cargaRota(const vector<int>& rota, const vector<int>& demandas) {
+    int carga = 0;
+    for (size_t i = 1; i + 1 < rota.size(); i++) carga += demandas[rota[i]];
+    return carga;
+}
+
+template <typename Rota>
+inline bool rotaJaExiste(const Rota& sub, const vector<Rota>& combinacoesValidas) {
+    // Verifica se 'sub' já existe em 'combinacoesValidas'
+    return find_if(combinacoesValidas.begin(), combinacoesValidas.end(), 
+                   [&sub](const Rota& existente) {
+                       return existente == sub;
+                   }) != combinacoesValidas.end();
+}
+
+// Função para verificar se há sobreposição de nós em todas as rotas
+// Cada combinação de rotas deve ter todos os nós e cada nó deve ser visitado apenas uma vez
+inline bool checkAllNodesWithoutOverlap(const vector<vector<int>>& routes, int totalNodes) {
+    set<int> visitedNodes;
+    for (const auto& route : routes) {
+        for (int node : route) {
+            // Ignore the depot node (assumed to be 0) if necessary
+            if (node == 0) continue;
+            // Check if the node has already been visited
+            if (visitedNodes.find(node) != visitedNodes.end()) {
+                return false; // Node overlap found
+            }
+            visitedNodes.insert(node);
+        }
+    }
+
+    // Check if all nodes are visited (ignoring the depot node if necessary)
+    return visitedNodes.size() == totalNodes - 1; // Subtract 1 if depot node is excluded
+}
+
+// Acrescenta a rota ao conjunto se ela ainda não estiver lá; retorna true se foi acrescentada.
+// Em vector a busca é linear; em PoolSequencias é feita pela tabela hash do pool.
+template <typename Rota>
+inline bool adicionarRotaSeNova(vector<Rota>& resultados, const Rota& sub) {
+    if (rotaJaExiste(sub, resultados)) return false;
+    resultados.push_back(sub);
+    return true;
+}
+
+template <typename Rota>
+inline bool adicionarRotaSeNova(PoolSequencias& resultados, const Rota& sub) {
+    return resultados.adicionarSeNova(sub);
+}
+
+// Versão sem alocação de checkAllNodesWithoutOverlap para a enumeração dos itinerários: as rotas são os índices
+// 'combinacao' do conjunto 'rotas' (vector de rotas ou PoolSequencias) e 'marcas' (um por nó) é reaproveitado entre
+// as chamadas, com um carimbo novo a cada uma
+template <typename Combinacao, typename Pool>
+inline bool cobreTodosOsNos(const Combinacao& combinacao, const Pool& rotas, int totalNodes, vector<unsigned>& marcas, unsigned& carimbo) {
+    if (marcas.size() < (size_t)totalNodes) marcas.assign(totalNodes, 0);
+    if (++carimbo == 0) {   // o carimbo deu a volta: limpa as marcas antigas
+        fill(marcas.begin(), marcas.end(), 0);
+        carimbo = 1;
+    }
+    int visitados = 0;
+    for (int indice : combinacao) {
+        for (int node : rotas[indice]) {
+            if (node == 0) continue;
+            if (marcas[node] == carimbo) return false;
+            marcas[node] = carimbo;
+            visitados++;
+        }
+    }
+    return visitados == totalNodes - 1;
+}
+
+// Função para calcular o custo total de uma combinação de rotas
+template <typename Combinacao, typename Pool, typename Matriz>
+inline int calculaCustoTotal(const Combinacao& combinacao, const Pool& rotas_possiveis, const Matriz& rotas) {
+    int custoTotal = 0;
+    for (const auto& indiceRota : combinacao) {
+        int custoRota = calcularCusto(rotas_possiveis[indiceRota], rotas);
+        if (custoRota == -1) return -1; // Se uma rota é inválida, toda a combinação é inválida
+        custoTotal += custoRota;
+    }
+    return custoTotal;
+}
+
+// Oferece como solução inicial o itinerário trivial com uma rota por cliente (0 i 0), se todas forem válidas.
+// Garante que haja uma solução para entregar mesmo que o limite seja atingido logo no início.
+inline void oferecerRotasIndividuais(const vector<vector<int>>& locais, const vector<int>& demandas, int capacidadeVeiculo, int numVertices,
+                              LimitesExecucao& limites, Incumbente& incumbente) {
+    vector<vector<int>> rotasIndividuais;
+    int custoTotal = 0;
+    for (int i = 1; i < numVertices; i++) {
+        vector<int> rota = {0, i, 0};
+        int custo = calcularCusto(rota, locais);
+        if (custo == -1 || verificaCapacidade(rota, demandas, capacidadeVeiculo) == 0) return;
+        custoTotal += custo;
+        rotasIndividuais.push_back(rota);
+    }
+    incumbente.oferecer(custoTotal, rotasIndividuais, limites);
+}
+
+#endif